@@ -0,0 +1,164 @@
+#include "algorithm.h"
+#include "state.h"
+#include "megaminx.h"
+#include "turn_kernel.h"
+#include "exceptions.h"
+#include <assert.h>
+#include <cctype>
+#include <algorithm>
+
+namespace Megaminx {
+
+  // Constructor
+  Algorithm::Algorithm()
+  {
+    compose();
+  }
+
+  // Parse from instructions
+  Algorithm::Algorithm(const std::string& instructions)
+  {
+    auto pos = instructions.begin();
+    auto end = instructions.end();
+    while(pos != end) {
+      char col = *pos;
+      int f = face_index(col);
+      if (f < 0) {
+        throw invalid_instruction(std::string("No such face with colour ") + col);
+      }
+      ++pos;
+      if (pos == end) {
+        throw invalid_instruction("No direction given");
+      }
+      char dir = *pos;
+      if (dir != '<' && dir != '>') {
+        throw invalid_instruction(std::string("Invalid direction given") + dir);
+      }
+      ++pos;
+      // See if there is a number
+      int num = 1;
+      if (pos != end && std::isdigit(*pos)) {
+        num = *pos - '0';
+        assert(num >= 0 && num <= 9);
+        if (num == 0) {
+          throw invalid_instruction("Zero is not a valid number of moves");
+        }
+        ++pos;
+      }
+      m_moves.insert(m_moves.end(), num, make_move(f, dir == '>'));
+      // Iterate past any spaces
+      while (pos != end && *pos == ' ') {
+        ++pos;
+      }
+    }
+    compose();
+  }
+
+  // Construct from moves
+  Algorithm::Algorithm(const std::vector<Move>& moves)
+    : m_moves(moves)
+  {
+    compose();
+  }
+
+  // Work out the composed permutation
+  void Algorithm::compose()
+  {
+    for (int i=0;i<120;++i) {
+      m_permutation[i] = (unsigned char)i;
+    }
+    for (Move m : m_moves) {
+      assert(m >= 0 && m < num_moves);
+      const unsigned char* from = move_permutation(m);
+      std::array<unsigned char,120> before = m_permutation;
+      for (int i=0;i<120;++i) {
+        m_permutation[i] = before[from[i]];
+      }
+    }
+  }
+
+  const std::vector<Move>& Algorithm::moves() const
+  {
+    return m_moves;
+  }
+
+  size_t Algorithm::size() const
+  {
+    return m_moves.size();
+  }
+
+  bool Algorithm::empty() const
+  {
+    return m_moves.empty();
+  }
+
+  // Return the instructions
+  std::string Algorithm::str() const
+  {
+    std::string result;
+    auto pos = m_moves.begin();
+    auto end = m_moves.end();
+    while (pos != end) {
+      // Count repeats of the same move up to 9
+      auto run = pos;
+      while (run != end && *run == *pos && run - pos < 9) {
+        ++run;
+      }
+      if (!result.empty()) {
+        result += ' ';
+      }
+      result += move_str(*pos);
+      if (run - pos > 1) {
+        result += (char)('0' + (run - pos));
+      }
+      pos = run;
+    }
+    return result;
+  }
+
+  const unsigned char* Algorithm::permutation() const
+  {
+    return m_permutation.data();
+  }
+
+  // Apply to a state
+  void Algorithm::apply(MegaminxState& state) const
+  {
+    permute_facets(state.data(), m_permutation.data());
+  }
+
+  // Apply to a megaminx
+  void Algorithm::apply(Megaminx& megaminx) const
+  {
+    apply(megaminx.state());
+  }
+
+  // Return the inverse
+  Algorithm Algorithm::inverse() const
+  {
+    std::vector<Move> moves;
+    moves.reserve(m_moves.size());
+    for (auto m = m_moves.rbegin(); m != m_moves.rend(); ++m) {
+      moves.push_back(inverse_move(*m));
+    }
+    return Algorithm(moves);
+  }
+
+  // Concatenate
+  Algorithm Algorithm::operator+(const Algorithm& other) const
+  {
+    std::vector<Move> moves(m_moves);
+    moves.insert(moves.end(), other.m_moves.begin(), other.m_moves.end());
+    return Algorithm(moves);
+  }
+
+  bool Algorithm::operator==(const Algorithm& other) const
+  {
+    return m_moves == other.m_moves;
+  }
+
+  bool Algorithm::operator!=(const Algorithm& other) const
+  {
+    return !(*this == other);
+  }
+}
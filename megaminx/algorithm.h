@@ -0,0 +1,84 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <array>
+#include "moves.h"
+
+namespace Megaminx {
+
+  // Predeclarations
+  class MegaminxState;
+  class Megaminx;
+
+  /**
+   * A sequence of moves parsed once and composed into a single
+   * facet permutation so it can be applied to any number of states
+   * in one pass.
+   */
+  class Algorithm {
+    public:
+      // Constructor
+      // The empty algorithm which leaves the state unchanged
+      Algorithm();
+
+      /**
+       * Parse an algorithm from instructions in the form used by
+       * Megaminx::apply() eg. "x> Y< G>2"
+       * Throws a Megaminx::invalid_instruction if the instructions
+       * are not valid
+       * @param instructions The instructions
+       */
+      explicit Algorithm(const std::string& instructions);
+
+      /**
+       * Construct from a list of moves
+       * @param moves The moves in the order they are made
+       */
+      explicit Algorithm(const std::vector<Move>& moves);
+
+      // The individual moves in the order they are made
+      const std::vector<Move>& moves() const;
+
+      // Number of individual turns
+      size_t size() const;
+
+      // Return if there are no moves
+      bool empty() const;
+
+      // Return the instructions for this algorithm
+      // Repeated turns of a face are written with a count eg. "G>2"
+      std::string str() const;
+
+      /**
+       * The composed facet permutation
+       * After applying the algorithm facet i holds what was at
+       * facet permutation()[i] before.
+       */
+      const unsigned char* permutation() const;
+
+      // Apply the algorithm to a state
+      void apply(MegaminxState& state) const;
+
+      // Apply the algorithm to a megaminx
+      void apply(Megaminx& megaminx) const;
+
+      // Return the algorithm that undoes this one
+      Algorithm inverse() const;
+
+      // Return this algorithm followed by another
+      Algorithm operator+(const Algorithm& other) const;
+
+      bool operator==(const Algorithm& other) const;
+      bool operator!=(const Algorithm& other) const;
+
+    protected:
+    private:
+      // Work out the composed permutation from the moves
+      void compose();
+
+      std::vector<Move> m_moves;
+      std::array<unsigned char,120> m_permutation;
+  };
+
+}
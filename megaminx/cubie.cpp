@@ -0,0 +1,332 @@
+#include "cubie.h"
+#include "state.h"
+#include "megaminx.h"
+#include "exceptions.h"
+#include <assert.h>
+#include <string>
+
+namespace Megaminx {
+
+  namespace {
+    const int num_corners = CubieState::num_corners;
+    const int num_edges = CubieState::num_edges;
+    const int num_facets = MegaminxState::num_facets;
+
+    // Where the pieces are in the facet model and how moves shift them
+    struct CubieGeometry {
+      int corner_facets[num_corners][3];
+      int edge_facets[num_edges][2];
+
+      // The slot each facet belongs to and its position within it
+      // Even facets are corners and odd facets are edges
+      int facet_slot[num_facets];
+      int facet_position[num_facets];
+
+      // For each move the slot each piece comes from and the change
+      // in its orientation
+      unsigned char corner_from[num_moves][num_corners];
+      unsigned char corner_twist[num_moves][num_corners];
+      unsigned char edge_from[num_moves][num_edges];
+      unsigned char edge_flip[num_moves][num_edges];
+    };
+
+    CubieGeometry build_geometry()
+    {
+      CubieGeometry g;
+
+      // Corners are numbered by their lowest indexed face. Facets go round
+      // the corner in the same order Face::rotate_corner_clockwise() moves them
+      int corner = 0;
+      for (int f=0;f<12;++f) {
+        for (int c=0;c<5;++c) {
+          int before = face_index(connections[f][(c+4)%5]);
+          int after = face_index(connections[f][c]);
+          if (before < f || after < f) {
+            continue;
+          }
+          g.corner_facets[corner][0] = f*10 + c*2;
+          g.corner_facets[corner][1] = before*10 + connecting_edge(before,f)*2;
+          g.corner_facets[corner][2] = after*10 + (connecting_edge(after,f)*2 + 2) % 10;
+          ++corner;
+        }
+      }
+      assert(corner == num_corners);
+
+      int edge = 0;
+      for (int f=0;f<12;++f) {
+        for (int e=0;e<5;++e) {
+          int other = face_index(connections[f][e]);
+          if (other < f) {
+            continue;
+          }
+          g.edge_facets[edge][0] = f*10 + e*2 + 1;
+          g.edge_facets[edge][1] = other*10 + connecting_edge(other,f)*2 + 1;
+          ++edge;
+        }
+      }
+      assert(edge == num_edges);
+
+      for (int k=0;k<num_corners;++k) {
+        for (int i=0;i<3;++i) {
+          g.facet_slot[g.corner_facets[k][i]] = k;
+          g.facet_position[g.corner_facets[k][i]] = i;
+        }
+      }
+      for (int k=0;k<num_edges;++k) {
+        for (int i=0;i<2;++i) {
+          g.facet_slot[g.edge_facets[k][i]] = k;
+          g.facet_position[g.edge_facets[k][i]] = i;
+        }
+      }
+
+      // Derive the piece moves from the facet moves
+      for (Move m=0;m<num_moves;++m) {
+        const unsigned char* from = move_permutation(m);
+        for (int k=0;k<num_corners;++k) {
+          int source = from[g.corner_facets[k][0]];
+          int slot = g.facet_slot[source];
+          int t = g.facet_position[source];
+          for (int i=0;i<3;++i) {
+            assert(from[g.corner_facets[k][i]] == g.corner_facets[slot][(t+i)%3]);
+          }
+          g.corner_from[m][k] = (unsigned char)slot;
+          g.corner_twist[m][k] = (unsigned char)((3 - t) % 3);
+        }
+        for (int k=0;k<num_edges;++k) {
+          int source = from[g.edge_facets[k][0]];
+          int slot = g.facet_slot[source];
+          int t = g.facet_position[source];
+          assert(from[g.edge_facets[k][1]] == g.edge_facets[slot][1-t]);
+          g.edge_from[m][k] = (unsigned char)slot;
+          g.edge_flip[m][k] = (unsigned char)t;
+        }
+      }
+      return g;
+    }
+
+    const CubieGeometry& geometry()
+    {
+      static const CubieGeometry g = build_geometry();
+      return g;
+    }
+
+    // The colour a facet has when the puzzle is solved
+    char solved_colour(int facet)
+    {
+      return colours[facet / 10];
+    }
+  }
+
+  // Constructor
+  CubieState::CubieState()
+  {
+    for (int i=0;i<num_corners;++i) {
+      m_corners[i] = (unsigned char)i;
+    }
+    for (int i=0;i<num_edges;++i) {
+      m_edges[i] = (unsigned char)i;
+    }
+    m_twists.fill(0);
+    m_flips.fill(0);
+  }
+
+  // Construct from facets
+  CubieState::CubieState(const MegaminxState& state)
+  {
+    const CubieGeometry& g = geometry();
+    const char* facets = state.data();
+
+    std::array<bool,num_corners> corner_seen;
+    corner_seen.fill(false);
+    for (int k=0;k<num_corners;++k) {
+      const int* slot = g.corner_facets[k];
+      bool found = false;
+      for (int j=0;j<num_corners && !found;++j) {
+        const int* piece = g.corner_facets[j];
+        for (int t=0;t<3 && !found;++t) {
+          found = facets[slot[t]] == solved_colour(piece[0]) &&
+            facets[slot[(t+1)%3]] == solved_colour(piece[1]) &&
+            facets[slot[(t+2)%3]] == solved_colour(piece[2]);
+          if (found) {
+            if (corner_seen[j]) {
+              throw invalid_state("Corner piece appears more than once");
+            }
+            corner_seen[j] = true;
+            m_corners[k] = (unsigned char)j;
+            m_twists[k] = (unsigned char)t;
+          }
+        }
+      }
+      if (!found) {
+        throw invalid_state(std::string("No corner piece in slot ") + std::to_string(k));
+      }
+    }
+
+    std::array<bool,num_edges> edge_seen;
+    edge_seen.fill(false);
+    for (int k=0;k<num_edges;++k) {
+      const int* slot = g.edge_facets[k];
+      bool found = false;
+      for (int j=0;j<num_edges && !found;++j) {
+        const int* piece = g.edge_facets[j];
+        for (int t=0;t<2 && !found;++t) {
+          found = facets[slot[t]] == solved_colour(piece[0]) &&
+            facets[slot[1-t]] == solved_colour(piece[1]);
+          if (found) {
+            if (edge_seen[j]) {
+              throw invalid_state("Edge piece appears more than once");
+            }
+            edge_seen[j] = true;
+            m_edges[k] = (unsigned char)j;
+            m_flips[k] = (unsigned char)t;
+          }
+        }
+      }
+      if (!found) {
+        throw invalid_state(std::string("No edge piece in slot ") + std::to_string(k));
+      }
+    }
+  }
+
+  // Convert to facets
+  MegaminxState CubieState::facets() const
+  {
+    const CubieGeometry& g = geometry();
+    MegaminxState state;
+    char* facets = state.data();
+    for (int k=0;k<num_corners;++k) {
+      const int* piece = g.corner_facets[m_corners[k]];
+      for (int i=0;i<3;++i) {
+        facets[g.corner_facets[k][(m_twists[k]+i)%3]] = solved_colour(piece[i]);
+      }
+    }
+    for (int k=0;k<num_edges;++k) {
+      const int* piece = g.edge_facets[m_edges[k]];
+      for (int i=0;i<2;++i) {
+        facets[g.edge_facets[k][(m_flips[k]+i)%2]] = solved_colour(piece[i]);
+      }
+    }
+    return state;
+  }
+
+  // Apply a move
+  void CubieState::turn(Move m)
+  {
+    assert(m >= 0 && m < num_moves);
+    const CubieGeometry& g = geometry();
+    const std::array<unsigned char,num_corners> corners = m_corners;
+    const std::array<unsigned char,num_corners> twists = m_twists;
+    for (int k=0;k<num_corners;++k) {
+      int from = g.corner_from[m][k];
+      m_corners[k] = corners[from];
+      int twist = twists[from] + g.corner_twist[m][k];
+      m_twists[k] = (unsigned char)(twist >= 3 ? twist - 3 : twist);
+    }
+    const std::array<unsigned char,num_edges> edges = m_edges;
+    const std::array<unsigned char,num_edges> flips = m_flips;
+    for (int k=0;k<num_edges;++k) {
+      int from = g.edge_from[m][k];
+      m_edges[k] = edges[from];
+      m_flips[k] = flips[from] ^ g.edge_flip[m][k];
+    }
+  }
+
+  int CubieState::corner(int slot) const
+  {
+    assert(slot >= 0 && slot < num_corners);
+    return m_corners[slot];
+  }
+
+  int CubieState::corner_orientation(int slot) const
+  {
+    assert(slot >= 0 && slot < num_corners);
+    return m_twists[slot];
+  }
+
+  int CubieState::edge(int slot) const
+  {
+    assert(slot >= 0 && slot < num_edges);
+    return m_edges[slot];
+  }
+
+  int CubieState::edge_orientation(int slot) const
+  {
+    assert(slot >= 0 && slot < num_edges);
+    return m_flips[slot];
+  }
+
+  const std::array<unsigned char,CubieState::num_corners>& CubieState::corner_permutation() const
+  {
+    return m_corners;
+  }
+
+  const std::array<unsigned char,CubieState::num_corners>& CubieState::corner_orientations() const
+  {
+    return m_twists;
+  }
+
+  const std::array<unsigned char,CubieState::num_edges>& CubieState::edge_permutation() const
+  {
+    return m_edges;
+  }
+
+  const std::array<unsigned char,CubieState::num_edges>& CubieState::edge_orientations() const
+  {
+    return m_flips;
+  }
+
+  // Corner twist coordinate
+  uint32_t CubieState::twist_coordinate() const
+  {
+    uint32_t result = 0;
+    for (int k=num_corners-2;k>=0;--k) {
+      result = result * 3 + m_twists[k];
+    }
+    return result;
+  }
+
+  // Edge flip coordinate
+  uint32_t CubieState::flip_coordinate() const
+  {
+    uint32_t result = 0;
+    for (int k=num_edges-2;k>=0;--k) {
+      result = result * 2 + m_flips[k];
+    }
+    return result;
+  }
+
+  // Return if solved
+  bool CubieState::is_solved() const
+  {
+    return *this == CubieState();
+  }
+
+  bool CubieState::operator==(const CubieState& other) const
+  {
+    return m_corners == other.m_corners &&
+      m_twists == other.m_twists &&
+      m_edges == other.m_edges &&
+      m_flips == other.m_flips;
+  }
+
+  bool CubieState::operator!=(const CubieState& other) const
+  {
+    return !(*this == other);
+  }
+
+  // Facet index of a corner slot
+  int CubieState::corner_facet(int slot, int i)
+  {
+    assert(slot >= 0 && slot < num_corners);
+    assert(i >= 0 && i < 3);
+    return geometry().corner_facets[slot][i];
+  }
+
+  // Facet index of an edge slot
+  int CubieState::edge_facet(int slot, int i)
+  {
+    assert(slot >= 0 && slot < num_edges);
+    assert(i >= 0 && i < 2);
+    return geometry().edge_facets[slot][i];
+  }
+}
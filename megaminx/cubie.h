@@ -0,0 +1,94 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include "moves.h"
+
+namespace Megaminx {
+
+  // Predeclarations
+  class MegaminxState;
+
+  /**
+   * The puzzle described by its pieces rather than its facets
+   *
+   * Each of the 20 corner and 30 edge slots records which piece is in it
+   * and how that piece is twisted or flipped. Slot i is where piece i
+   * lives when solved. Corner orientation 0 -> 2 and edge orientation
+   * 0 -> 1 give the position within the slot of the piece's first facet,
+   * counting round the slot from the facet on its lowest indexed face.
+   */
+  class CubieState {
+    public:
+      static const int num_corners = 20;
+      static const int num_edges = 30;
+
+      // Constructor
+      // Initialise to the solved state
+      CubieState();
+
+      /**
+       * Construct from the facet model
+       * Throws a Megaminx::invalid_state if the facets do not describe
+       * every piece exactly once
+       * @param state The facet state
+       */
+      explicit CubieState(const MegaminxState& state);
+
+      // Convert back to the facet model
+      MegaminxState facets() const;
+
+      // Apply a move
+      void turn(Move m);
+
+      // The piece in a corner slot and its twist
+      int corner(int slot) const;
+      int corner_orientation(int slot) const;
+
+      // The piece in an edge slot and its flip
+      int edge(int slot) const;
+      int edge_orientation(int slot) const;
+
+      // The whole permutation and orientation arrays
+      const std::array<unsigned char,num_corners>& corner_permutation() const;
+      const std::array<unsigned char,num_corners>& corner_orientations() const;
+      const std::array<unsigned char,num_edges>& edge_permutation() const;
+      const std::array<unsigned char,num_edges>& edge_orientations() const;
+
+      // Corner twist coordinate 0 -> 3^19-1
+      // The last twist is fixed by the others so is not included
+      uint32_t twist_coordinate() const;
+
+      // Edge flip coordinate 0 -> 2^29-1
+      // The last flip is fixed by the others so is not included
+      uint32_t flip_coordinate() const;
+
+      // Return if the puzzle is solved
+      bool is_solved() const;
+
+      bool operator==(const CubieState& other) const;
+      bool operator!=(const CubieState& other) const;
+
+      /**
+       * Return the facet index of a corner slot 0 -> 2
+       * @param slot The corner slot 0 -> 19
+       * @param i The facet of the slot 0 -> 2
+       */
+      static int corner_facet(int slot, int i);
+
+      /**
+       * Return the facet index of an edge slot 0 -> 1
+       * @param slot The edge slot 0 -> 29
+       * @param i The facet of the slot 0 -> 1
+       */
+      static int edge_facet(int slot, int i);
+
+    protected:
+    private:
+      std::array<unsigned char,num_corners> m_corners;
+      std::array<unsigned char,num_corners> m_twists;
+      std::array<unsigned char,num_edges> m_edges;
+      std::array<unsigned char,num_edges> m_flips;
+  };
+
+}
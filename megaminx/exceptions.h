@@ -24,4 +24,7 @@ namespace Megaminx {
 
   // Exception thrown if an invalid instruction is given
   DERIVED_EXCEPTION(invalid_instruction);
+
+  // Exception thrown if a state does not describe a real set of pieces
+  DERIVED_EXCEPTION(invalid_state);
 }
@@ -1,4 +1,6 @@
 #include "face.h"
+#include "state.h"
+#include "megaminx.h"
 #include <assert.h>
 #include <algorithm>
 #include "exceptions.h"
@@ -8,14 +10,30 @@ namespace Megaminx
 {
   // Constructor
   Face::Face(char c) 
+    : m_state(nullptr),
+      m_index(-1)
   {
     m_colour = c;
-    m_facets.fill(c);
+    m_facets = m_own_facets.data();
+    m_own_facets.fill(c);
+  }
+
+  // View constructor
+  Face::Face(MegaminxState& state, int index)
+    : m_state(&state),
+      m_index(index)
+  {
+    m_colour = colours[index];
+    m_facets = state.face_facets(index);
   }
 
   // Copy constructor
+  // Always takes its own copy of the facets
   Face::Face(const Face& other)
+    : m_state(nullptr),
+      m_index(-1)
   {
+    m_facets = m_own_facets.data();
     become(other);
   }
 
@@ -29,26 +47,9 @@ namespace Megaminx
   // Return a string representation of the face
   std::string Face::str() const 
   {
-    if (!m_cached_state.empty()) {
-      return m_cached_state;
-    }
-    std::string result("");
+    std::string result;
     result.reserve(10);
-    bool different = false;
-    for(int i=0;i<10;++i) {
-      if (!different && i > 0) {
-        different = m_facets[i] != m_facets[i-1];
-      }
-      result += m_facets[i];
-    }
-    if (!different) {
-      // All facets are the same. Use shorthand notation
-      result = '[';
-      result += m_facets[0];
-      result += ']';
-    }
-    // Cache result
-    m_cached_state = result;
+    MegaminxState::append_face_str(result, m_facets);
     return result;
   }
 
@@ -68,9 +69,6 @@ namespace Megaminx
   // Set an individual facet of the face
   void Face::set_facet(int i, char c)
   {
-    // Clear the cached state
-    m_cached_state.clear();
-
     assert(i >= 0 && i < 10);
     m_facets[i] = c;
   }
@@ -95,18 +93,14 @@ namespace Megaminx
   // Rotate the face anticlockwise
   void Face::rotate_anticlockwise()
   {
-    // Clear the cached state
-    m_cached_state.clear();
-
-    // Grab the top two facets
-    std::array<char,2> top_two;
-    std::copy(m_facets.begin(),m_facets.begin()+2,top_two.begin()); 
-
-    // Shift rest of array up
-    std::copy(m_facets.begin()+2,m_facets.end(),m_facets.begin());
+    if (m_state) {
+      // Part of a complete puzzle so use the move table
+      m_state->turn(m_index, false);
+      return;
+    }
 
-    // Insert top two at bottom
-    std::copy(top_two.begin(),top_two.end(),m_facets.end()-2);
+    // Move the top two facets to the bottom
+    std::rotate(m_facets,m_facets+2,m_facets+10);
 
     // If we have connected faces rotate them too
     if (std::all_of(
@@ -126,18 +120,14 @@ namespace Megaminx
   // Rotate the face clockwise
   void Face::rotate_clockwise()
   {
-    // Clear the cached state
-    m_cached_state.clear();
-
-    // Grab the bottom two facets
-    std::array<char,2> bottom_two;
-    std::copy(m_facets.end()-2,m_facets.end(),bottom_two.begin()); 
-
-    // Shift rest of array down
-    std::copy_backward(m_facets.begin(),m_facets.end()-2,m_facets.end());
+    if (m_state) {
+      // Part of a complete puzzle so use the move table
+      m_state->turn(m_index, true);
+      return;
+    }
 
-    // Insert bottom two at top
-    std::copy(bottom_two.begin(),bottom_two.end(),m_facets.begin());
+    // Move the bottom two facets to the top
+    std::rotate(m_facets,m_facets+8,m_facets+10);
 
     // If we have connected faces rotate them too
     if (std::all_of(
@@ -166,9 +156,6 @@ namespace Megaminx
 
   void Face::rotate_corner(int corner, bool clockwise)
   {
-    // Clear the cached state
-    m_cached_state.clear();
-    
     assert(corner >=0 && corner < 5);
     int facet_index = corner * 2;
     int edge_before = corner - 1;
@@ -216,7 +203,7 @@ namespace Megaminx
     if (end_offset > 10) {
       end_offset = 10;
     }
-    std::copy(m_facets.begin()+offset,m_facets.begin()+end_offset,facets->begin());
+    std::copy(m_facets+offset,m_facets+end_offset,facets->begin());
     if (edge == 4) {
       // Last facet on the last edge is the first facet on the first edge
       (*facets)[2] = m_facets[0];
@@ -228,12 +215,9 @@ namespace Megaminx
   void Face::set_edge_facets(int edge, const std::array<char,3>& facets) {
     assert(edge >= 0 && edge < 5);
 
-    // Clear the cached state
-    m_cached_state.clear();
-
     int offset = edge * 2;
     int len = (edge == 4) ? 2 : 3;
-    std::copy(facets.begin(),facets.begin()+len,m_facets.begin()+offset);
+    std::copy(facets.begin(),facets.begin()+len,m_facets+offset);
     if (edge == 4) {
       // Setting last facet on the last edge is actually 
       // the first facet on the first edge
@@ -275,21 +259,7 @@ namespace Megaminx
   void Face::parse(const std::string& string)
   {
     //std::cout << "parse(\"" << string << "\");" << std::endl; 
-    // Clear the cached state
-    m_cached_state.clear();
-
-    if (string.size() == 3) {
-      if (string[0] != '[' || string[2] != ']') {
-        std::string message("Invalid string format for parse: ");
-        throw parse_error(message + string);
-      }
-      m_facets.fill(string[1]);
-    } else if (string.size() == 10) {
-      std::copy(string.begin(),string.end(),m_facets.begin());
-    } else {
-      std::string message("Invalid string length for parse: ");
-      throw parse_error(message + string);
-    }
+    MegaminxState::parse_face(string, m_facets);
   }
 
   std::shared_ptr<Face> Face::opposite_face() const
@@ -315,8 +285,17 @@ namespace Megaminx
 
   void Face::become(const Face& other) {
     m_colour = other.colour();
-    std::copy(other.m_facets.begin(), other.m_facets.end(), m_facets.begin());
-    m_cached_state = other.m_cached_state;
+    std::copy(other.m_facets, other.m_facets+10, m_facets);
+  }
+
+  // Take a private copy of the facets
+  void Face::detach() {
+    if (m_state) {
+      std::copy(m_facets, m_facets+10, m_own_facets.begin());
+      m_facets = m_own_facets.data();
+      m_state = nullptr;
+      m_index = -1;
+    }
   }
 
 }
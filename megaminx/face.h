@@ -5,12 +5,28 @@
 #include <memory>
 
 namespace Megaminx {
+
+  // Predeclarations
+  class MegaminxState;
+
   class Face {
     public:
       // Constructor
       // Initialise the array of facets with the given char
       Face(char c);
 
+      /**
+       * Construct a face as a view onto a face of a state
+       * Used by Megaminx to present its MegaminxState as faces.
+       * The facets are those of the state, so setting them or rotating
+       * the face changes the state. The state must outlive the face
+       * unless detach() is called.
+       * Rotations of a view are done with the state move tables.
+       * @param state The state holding the facets
+       * @param index The index of the face in the state 0 -> 11
+       */
+      Face(MegaminxState& state, int index);
+
       // Copy constructor
       Face(const Face& other);
 
@@ -86,6 +102,10 @@ namespace Megaminx {
       // Utility method for copy constructor and assignment operator
       void become(const Face& other);
 
+      // Take a private copy of the facets if this face is a view
+      // onto a state
+      void detach();
+
     protected:
     private:
       void rotate_corner(int corner, bool clockwise);
@@ -93,13 +113,19 @@ namespace Megaminx {
       // The colour of this face
       char m_colour;
 
-      // The array that holds the facets
-      std::array<char,10> m_facets;
+      // The facets of this face
+      // Points either at m_own_facets or into a MegaminxState
+      char* m_facets;
+
+      // The state this face is a view onto and its index in it
+      // m_state is null if the face holds its own facets
+      MegaminxState* m_state;
+      int m_index;
+
+      // Storage for the facets when the face is not a view
+      std::array<char,10> m_own_facets;
 
       // The array of connected faces
       std::array<std::weak_ptr<Face>,5> m_connected_faces;
-
-      // A cache of the string representation
-      mutable std::string m_cached_state;
   };
 }
@@ -0,0 +1,78 @@
+#include "facet_mask.h"
+#include "cubie.h"
+#include <assert.h>
+
+namespace Megaminx {
+
+  // The facets on a face
+  FacetMask face_mask(int face)
+  {
+    assert(face >= 0 && face < 12);
+    FacetMask mask;
+    for (int i=0;i<10;++i) {
+      mask.set(face*10 + i);
+    }
+    return mask;
+  }
+
+  // The facets of a corner
+  FacetMask corner_mask(int slot)
+  {
+    assert(slot >= 0 && slot < CubieState::num_corners);
+    FacetMask mask;
+    for (int i=0;i<3;++i) {
+      mask.set(CubieState::corner_facet(slot, i));
+    }
+    return mask;
+  }
+
+  // The facets of an edge
+  FacetMask edge_mask(int slot)
+  {
+    assert(slot >= 0 && slot < CubieState::num_edges);
+    FacetMask mask;
+    for (int i=0;i<2;++i) {
+      mask.set(CubieState::edge_facet(slot, i));
+    }
+    return mask;
+  }
+
+  // The facets of all the pieces on a face
+  FacetMask face_pieces_mask(int face)
+  {
+    FacetMask mask;
+    for (int slot : face_corners(face)) {
+      mask |= corner_mask(slot);
+    }
+    for (int slot : face_edges(face)) {
+      mask |= edge_mask(slot);
+    }
+    return mask;
+  }
+
+  // The corners on a face
+  std::vector<int> face_corners(int face)
+  {
+    assert(face >= 0 && face < 12);
+    std::vector<int> slots;
+    for (int slot=0;slot<CubieState::num_corners;++slot) {
+      if ((corner_mask(slot) & face_mask(face)).any()) {
+        slots.push_back(slot);
+      }
+    }
+    return slots;
+  }
+
+  // The edges on a face
+  std::vector<int> face_edges(int face)
+  {
+    assert(face >= 0 && face < 12);
+    std::vector<int> slots;
+    for (int slot=0;slot<CubieState::num_edges;++slot) {
+      if ((edge_mask(slot) & face_mask(face)).any()) {
+        slots.push_back(slot);
+      }
+    }
+    return slots;
+  }
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <bitset>
+#include <vector>
+
+namespace Megaminx {
+
+  /**
+   * One bit for each of the 120 facets of the puzzle
+   * Bits are in the same order as MegaminxState::data(), ten per face,
+   * so facet i of face f is bit f*10 + i. Even facets are corners and
+   * odd facets are edges. Used to compare only part of a state, such
+   * as the pieces a stage of a solve has to put in place.
+   */
+  typedef std::bitset<120> FacetMask;
+
+  /**
+   * Return the mask of the ten facets on a face
+   * @param face The face index 0 -> 11
+   */
+  FacetMask face_mask(int face);
+
+  /**
+   * Return the mask of every facet of a corner piece
+   * @param slot The corner slot 0 -> 19
+   */
+  FacetMask corner_mask(int slot);
+
+  /**
+   * Return the mask of every facet of an edge piece
+   * @param slot The edge slot 0 -> 29
+   */
+  FacetMask edge_mask(int slot);
+
+  /**
+   * Return the mask of every facet of the pieces on a face
+   * This is what has to be solved for the face to be solved as a layer,
+   * not just the ten facets showing on the face
+   * @param face The face index 0 -> 11
+   */
+  FacetMask face_pieces_mask(int face);
+
+  /**
+   * Return the corner slots that touch a face
+   * @param face The face index 0 -> 11
+   */
+  std::vector<int> face_corners(int face);
+
+  /**
+   * Return the edge slots that touch a face
+   * @param face The face index 0 -> 11
+   */
+  std::vector<int> face_edges(int face);
+
+}
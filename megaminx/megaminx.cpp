@@ -1,57 +1,69 @@
 #include "megaminx.h"
 #include "face.h"
+#include "algorithm.h"
 #include <assert.h>
 #include <string>
 #include <memory>
+#include <algorithm>
 #include "exceptions.h"
-#include <cctype>
 
 namespace Megaminx {
 
   // Globals
   const char* solved = "[w][r][G][p][Y][B][x][y][k][g][o][b]";
-  const char colours[12] = {'w','r','G','p','Y','B','x','y','k','g','o','b'};
-  extern const char connections[12][5] = {
-    {'r','G','p','Y','B'},
-    {'G','w','B','k','y'},
-    {'w','r','y','b','p'},
-    {'b','o','Y','w','G'},
-    {'g','B','w','p','o'},
-    {'Y','g','k','r','w'},
-    {'y','k','g','o','b'},
-    {'k','x','b','G','r'},
-    {'x','y','r','B','g'},
-    {'B','Y','o','x','k'},
-    {'p','b','x','g','Y'},
-    {'o','p','G','y','x'}
-  };
-
 
   // Constructor
   Megaminx::Megaminx()
   {
-    init();
   }
 
-  void Megaminx::init()
+  // Construct from a state
+  Megaminx::Megaminx(const MegaminxState& state)
+    : m_state(state)
+  {
+  }
+
+  void Megaminx::init() const
   {
-    // Construct the faces
+    // Construct the faces as views onto the state
     for (int i=0;i<12;++i) {
-      m_faces[i] = std::make_shared<Face>(colours[i]);
+      m_faces[i] = std::make_shared<Face>(m_state, i);
     }
     // Connect them up
     for (int i=0;i<12;++i) {
       for (int j=0;j<5;++j) {
-        m_faces[i]->connect(j,face(connections[i][j]));
+        m_faces[i]->connect(j,m_faces[face_index(connections[i][j])]);
       }
     }
   }
 
   // Copy constructor
+  // Only the state is copied. Faces are built if needed
   Megaminx::Megaminx(const Megaminx& other)
+    : m_state(other.m_state)
   {
-    init();
-    become(other);
+  }
+
+  // Destructor
+  Megaminx::~Megaminx()
+  {
+    for (auto& f : m_faces) {
+      if (f && f.use_count() > 1) {
+        // Someone is still holding on to this face
+        f->detach();
+      }
+    }
+  }
+
+  // Access the state
+  const MegaminxState& Megaminx::state() const
+  {
+    return m_state;
+  }
+
+  MegaminxState& Megaminx::state()
+  {
+    return m_state;
   }
 
   // Asignment operator
@@ -65,6 +77,7 @@ namespace Megaminx {
   std::shared_ptr<Face> Megaminx::face(int i) const
   {
     assert(i >=0 && i < 12);
+    std::call_once(m_faces_built, &Megaminx::init, this);
     return m_faces[i];
   }
 
@@ -72,8 +85,8 @@ namespace Megaminx {
   std::shared_ptr<Face> Megaminx::face(char col) const
   {
     for (int i=0;i<12;++i) {
-      if (m_faces[i]->colour() == col) {
-        return m_faces[i];
+      if (colours[i] == col) {
+        return face(i);
       }
     }
     throw face_not_found(std::string("No such face with colour ") + col);
@@ -82,88 +95,21 @@ namespace Megaminx {
   // Return string representation of the state
   std::string Megaminx::str() const
   {
-    std::string result;
-    result.reserve(120);
-    std::for_each(
-      m_faces.begin(),
-      m_faces.end(),
-      [&result](std::shared_ptr<Face> f) {result.append(f->str());}
-    );
-    return result;
+    return m_state.str();
   }
 
   void Megaminx::parse(const std::string& string)
   {
-    auto pos = string.begin();
-    for (int i=0; i<12; ++i) {
-      if (pos == string.end()) {
-        throw parse_error("String does not contain all faces");
-      }
-      if (*pos == '[') {
-        if (std::distance(pos,string.end()) < 3) {
-          throw parse_error("String not long enough");
-        }
-        m_faces[i]->parse(std::string(pos, pos+3));
-        pos += 3;
-      } else {
-        if (std::distance(pos,string.end()) < 10) {
-          throw parse_error("String not long enough");
-        }
-        m_faces[i]->parse(std::string(pos, pos+10));
-        pos += 10;
-      }
-    }
+    m_state.parse(string);
   }
 
   void Megaminx::apply(const std::string& instructions)
   {
-    auto pos = instructions.begin();
-    auto end = instructions.end();
-    while(pos != end) {
-      char col = *pos;
-      std::shared_ptr<Face> f;
-      try {
-        f = face(col);
-      } catch (face_not_found e) {
-        throw invalid_instruction(e.what());
-      }
-      ++pos;
-      if (pos == end) {
-        throw invalid_instruction("No direction given");
-      }
-      char dir = *pos;
-      if (dir != '<' && dir != '>') {
-        throw invalid_instruction(std::string("Invalid direction given") + dir);
-      }
-      ++pos;
-      // See if there is a number
-      int num = 1;
-      if (pos != end && std::isdigit(*pos)) {
-        num = *pos - '0';
-        assert(num >= 0 && num <= 9);
-        if (num == 0) {
-          throw invalid_instruction("Zero is not a valid number of moves");
-        }
-        ++pos;
-      }
-      for (int i=0; i<num; ++i) {
-        if (dir == '>') {
-          f->rotate_clockwise();
-        } else {
-          f->rotate_anticlockwise();
-        }
-      }
-      // Iterate past any spaces
-      while (pos != end && *pos == ' ') {
-        ++pos;
-      }
-    }
+    Algorithm(instructions).apply(m_state);
   }
 
   void Megaminx::become(const Megaminx& other)
   {
-    for (int i=0;i<12;++i) {
-      m_faces[i]->become(*other.m_faces[i]);
-    }
+    m_state = other.m_state;
   }
 }
@@ -3,6 +3,8 @@
 #include <string>
 #include <memory>
 #include <array>
+#include <mutex>
+#include "state.h"
 
 namespace Megaminx {
 
@@ -11,25 +13,61 @@ namespace Megaminx {
 
   // Globals
   extern const char* solved;
-  extern const char colours[12];
-  extern const char connections[12][5];
+
+  // The colours of the faces in index order
+  constexpr char colours[12] = {'w','r','G','p','Y','B','x','y','k','g','o','b'};
+
+  // The colours of the faces connected to each edge of each face
+  // Defined here so the move tables can be built from it at compile time
+  constexpr char connections[12][5] = {
+    {'r','G','p','Y','B'},
+    {'G','w','B','k','y'},
+    {'w','r','y','b','p'},
+    {'b','o','Y','w','G'},
+    {'g','B','w','p','o'},
+    {'Y','g','k','r','w'},
+    {'y','k','g','o','b'},
+    {'k','x','b','G','r'},
+    {'x','y','r','B','g'},
+    {'B','Y','o','x','k'},
+    {'p','b','x','g','Y'},
+    {'o','p','G','y','x'}
+  };
 
   /**
    * Class representing the megaminx puzzle
+   *
+   * The puzzle is held as a flat MegaminxState. The connected Face
+   * objects are only built the first time a face is asked for and are
+   * views onto that state, so copying a Megaminx is just a state copy.
+   * Faces may be asked for from several threads at once.
    */
   class Megaminx {
     public:
       // Constructor
       Megaminx();
 
+      // Construct from a state
+      explicit Megaminx(const MegaminxState& state);
+
       // Copy constructor
       Megaminx(const Megaminx& other);
 
       // Asignment operator
       Megaminx& operator=(const Megaminx& other);
 
+      // Destructor
+      // Any faces still referenced elsewhere are detached from the state
+      ~Megaminx();
+
+      // Access the underlying state
+      const MegaminxState& state() const;
+      MegaminxState& state();
+
       /**
        * Return a face of the puzzle by index
+       * The face is a view onto the state of this megaminx and
+       * is detached from it if the megaminx is destroyed
        * @param i The index 0 -> 11
        */
       std::shared_ptr<Face> face(int i) const;
@@ -50,6 +88,7 @@ namespace Megaminx {
       // inscrutions are in the form of colour + rotation [+number]
       // eg. "x> Y< G>2" for rotate grey clockwise, dark yellow anticlockwise
       // and green clockwise twice
+      // Use an Algorithm to apply the same instructions many times
       void apply(const std::string& instructions);
 
       // Utility function for asignment operator and copy constructor
@@ -57,9 +96,15 @@ namespace Megaminx {
 
     protected:
     private:
-      // Utility to do the guts of construction
-      void init();
-      std::array<std::shared_ptr<Face>,12> m_faces;
+      // Utility to build the connected faces on first use
+      void init() const;
+      // Faces of a const megaminx can still be turned, so the state
+      // they view is mutable
+      mutable MegaminxState m_state;
+      mutable std::array<std::shared_ptr<Face>,12> m_faces;
+      // Builds the faces once even if several threads ask at the same
+      // time. A copy starts with a new flag
+      mutable std::once_flag m_faces_built;
   };
 
 }
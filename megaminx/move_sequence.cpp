@@ -0,0 +1,88 @@
+#include "move_sequence.h"
+#include <assert.h>
+
+namespace Megaminx {
+
+  namespace {
+    // The state after a move made once or twice in a row
+    SequenceState after(Move m, int run)
+    {
+      return 1 + m * 2 + (run - 1);
+    }
+
+    // Work out the next state for every state and move
+    struct SequenceTables {
+      SequenceState next[num_sequence_states][num_moves];
+      SequenceSuccessors successors[num_sequence_states];
+    };
+
+    SequenceTables build_sequence_tables()
+    {
+      SequenceTables tables;
+      for (SequenceState s=0;s<num_sequence_states;++s) {
+        for (Move m=0;m<num_moves;++m) {
+          SequenceState next = after(m, 1);
+          if (s != sequence_start) {
+            Move last = (s - 1) / 2;
+            int run = (s - 1) % 2 + 1;
+            int face = move_face(m);
+            int last_face = move_face(last);
+            if (face == last_face) {
+              // Only the same turn again, and only once more
+              next = (m == last && run == 1) ? after(m, 2) : sequence_pruned;
+            } else if (face < last_face && !faces_adjacent(face, last_face)) {
+              // Faces that do not share an edge commute so only allow
+              // them in order
+              next = sequence_pruned;
+            }
+          }
+          tables.next[s][m] = next;
+        }
+        SequenceSuccessors& successors = tables.successors[s];
+        successors.count = 0;
+        for (Move m=0;m<num_moves;++m) {
+          if (tables.next[s][m] != sequence_pruned) {
+            successors.moves[successors.count] = m;
+            successors.next[successors.count] = tables.next[s][m];
+            ++successors.count;
+          }
+        }
+      }
+      return tables;
+    }
+
+    const SequenceTables& sequence_tables()
+    {
+      static const SequenceTables tables = build_sequence_tables();
+      return tables;
+    }
+  }
+
+  // Return the state after a move
+  SequenceState next_sequence_state(SequenceState state, Move m)
+  {
+    assert(state >= 0 && state < num_sequence_states);
+    assert(m >= 0 && m < num_moves);
+    return sequence_tables().next[state][m];
+  }
+
+  // Return the moves allowed from a state
+  const SequenceSuccessors& sequence_successors(SequenceState state)
+  {
+    assert(state >= 0 && state < num_sequence_states);
+    return sequence_tables().successors[state];
+  }
+
+  // Check a whole sequence
+  bool is_canonical(const std::vector<Move>& moves)
+  {
+    SequenceState state = sequence_start;
+    for (Move m : moves) {
+      state = next_sequence_state(state, m);
+      if (state == sequence_pruned) {
+        return false;
+      }
+    }
+    return true;
+  }
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <vector>
+#include "moves.h"
+
+namespace Megaminx {
+
+  /**
+   * State of the automaton that only allows canonical move sequences
+   *
+   * A sequence is canonical if it never undoes the last move, never
+   * turns a face the same way more than twice in a row (three turns is
+   * two the other way) and only turns faces that commute, being those
+   * that do not share an edge such as opposite faces, in increasing face
+   * order. Every sequence has a canonical one that is no
+   * longer and does the same thing, so a search can skip everything
+   * else without losing any solutions.
+   *
+   * State 0 is the start. Otherwise the state records the last move and
+   * whether it was made once or twice in a row.
+   */
+  typedef int SequenceState;
+
+  // Number of automaton states
+  const int num_sequence_states = 1 + 2 * num_moves;
+
+  // The state before any moves are made
+  const SequenceState sequence_start = 0;
+
+  // Returned for a move that is not allowed
+  const SequenceState sequence_pruned = -1;
+
+  // The moves allowed from a state and the state each one leads to
+  struct SequenceSuccessors {
+    int count;
+    Move moves[num_moves];
+    SequenceState next[num_moves];
+  };
+
+  /**
+   * Return the state after a move
+   * @param state The current state
+   * @param m The move
+   * @return The next state or sequence_pruned if the move is not allowed
+   */
+  SequenceState next_sequence_state(SequenceState state, Move m);
+
+  // Return the moves allowed from a state
+  const SequenceSuccessors& sequence_successors(SequenceState state);
+
+  // Return if a whole sequence of moves is canonical
+  bool is_canonical(const std::vector<Move>& moves);
+}
@@ -0,0 +1,80 @@
+#include "move_stack.h"
+#include "state.h"
+#include "algorithm.h"
+#include <assert.h>
+
+namespace Megaminx {
+
+  // Constructor
+  MoveStack::MoveStack(MegaminxState& state, size_t capacity)
+    : m_state(&state)
+  {
+    m_moves.reserve(capacity);
+  }
+
+  MegaminxState& MoveStack::state()
+  {
+    return *m_state;
+  }
+
+  const MegaminxState& MoveStack::state() const
+  {
+    return *m_state;
+  }
+
+  // Make a move
+  void MoveStack::push(Move m)
+  {
+    m_state->turn(m);
+    m_moves.push_back(m);
+  }
+
+  // Take back the last move
+  Move MoveStack::pop()
+  {
+    assert(!m_moves.empty());
+    Move m = m_moves.back();
+    m_moves.pop_back();
+    m_state->undo_move(m);
+    return m;
+  }
+
+  Move MoveStack::top() const
+  {
+    assert(!m_moves.empty());
+    return m_moves.back();
+  }
+
+  size_t MoveStack::depth() const
+  {
+    return m_moves.size();
+  }
+
+  bool MoveStack::empty() const
+  {
+    return m_moves.empty();
+  }
+
+  // Take back everything
+  void MoveStack::unwind()
+  {
+    while (!m_moves.empty()) {
+      pop();
+    }
+  }
+
+  const std::vector<Move>& MoveStack::moves() const
+  {
+    return m_moves;
+  }
+
+  Algorithm MoveStack::algorithm() const
+  {
+    return Algorithm(m_moves);
+  }
+
+  std::string MoveStack::str() const
+  {
+    return algorithm().str();
+  }
+}
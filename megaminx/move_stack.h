@@ -0,0 +1,68 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include "moves.h"
+
+namespace Megaminx {
+
+  // Predeclarations
+  class MegaminxState;
+  class Algorithm;
+
+  /**
+   * Moves made in place on a state, recorded so they can be taken back
+   *
+   * The stack is a view onto a state. push() makes a move on it and
+   * pop() takes the last one back, so a depth first search can walk the
+   * whole tree on one state. Once the stack has grown to the depth of the
+   * search no more memory is allocated.
+   */
+  class MoveStack {
+    public:
+      /**
+       * Constructor
+       * @param state The state to make the moves on
+       * @param capacity The depth to reserve room for
+       */
+      explicit MoveStack(MegaminxState& state, size_t capacity = 64);
+
+      // The state the moves are made on
+      MegaminxState& state();
+      const MegaminxState& state() const;
+
+      // Make a move and record it
+      void push(Move m);
+
+      // Take back the last move and return it
+      Move pop();
+
+      // Return the last move made
+      Move top() const;
+
+      // Number of moves made
+      size_t depth() const;
+
+      // Return if no moves have been made
+      bool empty() const;
+
+      // Take back all the moves
+      void unwind();
+
+      // The moves made from first to last
+      const std::vector<Move>& moves() const;
+
+      // The moves made as an algorithm
+      Algorithm algorithm() const;
+
+      // The moves made in Megaminx::apply() notation
+      std::string str() const;
+
+    protected:
+    private:
+      MegaminxState* m_state;
+      std::vector<Move> m_moves;
+  };
+
+}
@@ -0,0 +1,184 @@
+#include "moves.h"
+#include "megaminx.h"
+#include "state.h"
+#include "exceptions.h"
+#include <assert.h>
+
+namespace Megaminx {
+
+  namespace {
+    const int num_facets = MegaminxState::num_facets;
+
+    // The facet permutation of every move
+    struct MoveTables {
+      unsigned char from[num_moves][num_facets];
+    };
+
+    constexpr int colour_index(char col)
+    {
+      for (int i=0;i<12;++i) {
+        if (colours[i] == col) {
+          return i;
+        }
+      }
+      return -1;
+    }
+
+    // The edge of a face that is connected to another face
+    constexpr int find_connecting_edge(int face, int other)
+    {
+      for (int i=0;i<5;++i) {
+        if (connections[face][i] == colours[other]) {
+          return i;
+        }
+      }
+      return -1;
+    }
+
+    // Index of facet k 0 -> 2 along an edge of a face
+    // Matches Face::edge_facets()
+    constexpr int edge_facet(int face, int edge, int k)
+    {
+      return face * 10 + (edge * 2 + k) % 10;
+    }
+
+    // Work out where every facet comes from for each move
+    // This follows exactly what Face::rotate_clockwise() and
+    // Face::rotate_anticlockwise() do to a fully connected face
+    constexpr MoveTables build_move_tables()
+    {
+      MoveTables tables{};
+      for (int m=0;m<num_moves;++m) {
+        int face = m / 2;
+        bool clockwise = (m % 2) == 0;
+        unsigned char* from = tables.from[m];
+        for (int i=0;i<num_facets;++i) {
+          from[i] = (unsigned char)i;
+        }
+        // The facets of the face itself move round two places
+        for (int i=0;i<10;++i) {
+          from[face*10 + i] = (unsigned char)(face*10 + (i + (clockwise ? 8 : 2)) % 10);
+        }
+        // The connected edges each take the facets of their neighbour
+        for (int e=0;e<5;++e) {
+          int src = (e + (clockwise ? 4 : 1)) % 5;
+          int to_face = colour_index(connections[face][e]);
+          int to_edge = find_connecting_edge(to_face, face);
+          int from_face = colour_index(connections[face][src]);
+          int from_edge = find_connecting_edge(from_face, face);
+          for (int k=0;k<3;++k) {
+            from[edge_facet(to_face,to_edge,k)] =
+              (unsigned char)edge_facet(from_face,from_edge,k);
+          }
+        }
+      }
+      return tables;
+    }
+
+    constexpr MoveTables move_tables = build_move_tables();
+
+    // Return if two faces share an edge
+    constexpr bool adjacent(int face, int other)
+    {
+      for (int i=0;i<5;++i) {
+        if (connections[face][i] == colours[other]) {
+          return true;
+        }
+      }
+      return false;
+    }
+
+    // The opposite face is the one that is not the face, one of its
+    // neighbours or one of their neighbours
+    constexpr int find_opposite(int face)
+    {
+      for (int other=0;other<12;++other) {
+        bool near = other == face || adjacent(face, other);
+        for (int i=0;i<5 && !near;++i) {
+          int neighbour = colour_index(connections[face][i]);
+          near = adjacent(neighbour, other);
+        }
+        if (!near) {
+          return other;
+        }
+      }
+      return -1;
+    }
+
+    struct OppositeTable {
+      int face[12];
+    };
+
+    constexpr OppositeTable build_opposite_table()
+    {
+      OppositeTable table{};
+      for (int f=0;f<12;++f) {
+        table.face[f] = find_opposite(f);
+      }
+      return table;
+    }
+
+    constexpr OppositeTable opposite_table = build_opposite_table();
+  }
+
+  // Return the index of a face by colour
+  int face_index(char col)
+  {
+    return colour_index(col);
+  }
+
+  // Return if two faces share an edge
+  bool faces_adjacent(int face, int other)
+  {
+    assert(face >= 0 && face < 12);
+    assert(other >= 0 && other < 12);
+    return adjacent(face, other);
+  }
+
+  // Return the edge of a face connected to another face
+  int connecting_edge(int face, int other)
+  {
+    assert(face >= 0 && face < 12);
+    assert(other >= 0 && other < 12);
+    return find_connecting_edge(face, other);
+  }
+
+  // Return the face opposite a face
+  int opposite_face(int face)
+  {
+    assert(face >= 0 && face < 12);
+    return opposite_table.face[face];
+  }
+
+  // Return the move in apply() notation
+  std::string move_str(Move m)
+  {
+    assert(m >= 0 && m < num_moves);
+    std::string result(1, colours[move_face(m)]);
+    result += move_clockwise(m) ? '>' : '<';
+    return result;
+  }
+
+  // Return the move from its notation
+  Move parse_move(const std::string& str)
+  {
+    if (str.size() != 2) {
+      throw invalid_instruction("Not a single move: " + str);
+    }
+    int face = colour_index(str[0]);
+    if (face < 0) {
+      throw invalid_instruction(std::string("No such face with colour ") + str[0]);
+    }
+    if (str[1] != '<' && str[1] != '>') {
+      throw invalid_instruction(std::string("Invalid direction given") + str[1]);
+    }
+    return make_move(face, str[1] == '>');
+  }
+
+  // Return the facet permutation for a move
+  const unsigned char* move_permutation(Move m)
+  {
+    assert(m >= 0 && m < num_moves);
+    return move_tables.from[m];
+  }
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <string>
+
+namespace Megaminx {
+
+  // A move is a turn of a single face clockwise or anticlockwise
+  // Encoded as face index * 2, plus one for anticlockwise
+  typedef int Move;
+
+  // Number of distinct moves (12 faces x 2 directions)
+  const int num_moves = 24;
+
+  // Make a move from a face index 0 -> 11 and direction
+  inline Move make_move(int face, bool clockwise)
+  {
+    return face * 2 + (clockwise ? 0 : 1);
+  }
+
+  // Return the index of the face turned by a move
+  inline int move_face(Move m)
+  {
+    return m >> 1;
+  }
+
+  // Return if the move is a clockwise turn
+  inline bool move_clockwise(Move m)
+  {
+    return (m & 1) == 0;
+  }
+
+  // Return the move that undoes a move
+  inline Move inverse_move(Move m)
+  {
+    return m ^ 1;
+  }
+
+  /**
+   * Return the index of the face with the given colour
+   * Returns -1 if there is no such face
+   * @param col The colour
+   */
+  int face_index(char col);
+
+  /**
+   * Return if two faces share an edge
+   * Turns of faces that do not share an edge have no pieces in common
+   * so they commute
+   * @param face The face index 0 -> 11
+   * @param other The other face index 0 -> 11
+   */
+  bool faces_adjacent(int face, int other);
+
+  /**
+   * Return the edge 0 -> 4 of a face that is connected to another face
+   * Returns -1 if the faces are not adjacent
+   * @param face The face index 0 -> 11
+   * @param other The other face index 0 -> 11
+   */
+  int connecting_edge(int face, int other);
+
+  /**
+   * Return the index of the face opposite a face
+   * Turns of opposite faces do not share any pieces so they commute
+   * @param face The face index 0 -> 11
+   */
+  int opposite_face(int face);
+
+  // Return the move in the notation used by Megaminx::apply() eg. "x>"
+  std::string move_str(Move m);
+
+  /**
+   * Return the move from its notation eg. "x>"
+   * Throws a Megaminx::invalid_instruction if it is not a single move
+   * @param str The move as given by move_str()
+   */
+  Move parse_move(const std::string& str);
+
+  /**
+   * Return the facet permutation for a move
+   * After the move facet i of the state holds what was at facet
+   * move_permutation(m)[i] before it.
+   * The tables are built at compile time from the connections table.
+   * @param m The move 0 -> 23
+   */
+  const unsigned char* move_permutation(Move m);
+}
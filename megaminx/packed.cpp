@@ -0,0 +1,160 @@
+#include "packed.h"
+#include "state.h"
+#include "megaminx.h"
+#include "exceptions.h"
+#include <assert.h>
+#include <string.h>
+#include <stdint.h>
+#include <array>
+#include <type_traits>
+
+namespace Megaminx {
+
+  static_assert(std::is_trivially_copyable<PackedState>::value,
+    "PackedState must be trivially copyable");
+
+  namespace {
+    const int num_facets = MegaminxState::num_facets;
+
+    // Lookup from a facet colour to its nibble. Zero for an invalid colour
+    std::array<unsigned char,256> build_nibble_table()
+    {
+      std::array<unsigned char,256> table;
+      table.fill(0);
+      for (int i=0;i<12;++i) {
+        table[(unsigned char)colours[i]] = (unsigned char)(i + 1);
+      }
+      return table;
+    }
+
+    const std::array<unsigned char,256>& nibble_table()
+    {
+      static const std::array<unsigned char,256> table = build_nibble_table();
+      return table;
+    }
+
+    bool valid_nibble(unsigned char nibble)
+    {
+      return nibble >= 1 && nibble <= 12;
+    }
+
+    uint64_t load_word(const unsigned char* bytes)
+    {
+      uint64_t word;
+      memcpy(&word, bytes, sizeof(word));
+      return word;
+    }
+  }
+
+  // Constructor
+  PackedState::PackedState()
+  {
+    static const PackedState solved_state((MegaminxState()));
+    *this = solved_state;
+  }
+
+  // Pack a state
+  PackedState::PackedState(const MegaminxState& state)
+  {
+    const std::array<unsigned char,256>& table = nibble_table();
+    const char* facets = state.data();
+    for (int i=0;i<num_bytes;++i) {
+      unsigned char lo = table[(unsigned char)facets[2*i]];
+      unsigned char hi = table[(unsigned char)facets[2*i+1]];
+      if (lo == 0 || hi == 0) {
+        throw invalid_state("Facet is not a valid colour");
+      }
+      m_bytes[i] = (unsigned char)(lo | (hi << 4));
+    }
+    memset(m_bytes + num_bytes, 0, sizeof(m_bytes) - num_bytes);
+  }
+
+  // Unpack to a state
+  MegaminxState PackedState::unpack() const
+  {
+    MegaminxState state;
+    char* facets = state.data();
+    for (int i=0;i<num_bytes;++i) {
+      facets[2*i] = colours[(m_bytes[i] & 0xf) - 1];
+      facets[2*i+1] = colours[(m_bytes[i] >> 4) - 1];
+    }
+    return state;
+  }
+
+  const unsigned char* PackedState::bytes() const
+  {
+    return m_bytes;
+  }
+
+  // Construct from bytes
+  PackedState PackedState::from_bytes(const unsigned char* bytes)
+  {
+    PackedState result;
+    for (int i=0;i<num_bytes;++i) {
+      if (!valid_nibble(bytes[i] & 0xf) || !valid_nibble(bytes[i] >> 4)) {
+        throw invalid_state("Invalid packed state");
+      }
+    }
+    memcpy(result.m_bytes, bytes, num_bytes);
+    return result;
+  }
+
+  // Return the encoding as a key
+  std::string PackedState::key() const
+  {
+    return std::string((const char*)m_bytes, num_bytes);
+  }
+
+  // Construct from a key
+  PackedState PackedState::from_key(const std::string& key)
+  {
+    if (key.size() != num_bytes) {
+      throw invalid_state("Packed state key is the wrong length");
+    }
+    return from_bytes((const unsigned char*)key.data());
+  }
+
+  // Hash the encoding a word at a time
+  size_t PackedState::hash() const
+  {
+    uint64_t h = 0x9e3779b97f4a7c15ULL;
+    for (int i=0;i<8;++i) {
+      h ^= load_word(m_bytes + i*8);
+      h *= 0xff51afd7ed558ccdULL;
+      h ^= h >> 32;
+    }
+    return (size_t)h;
+  }
+
+  bool PackedState::operator==(const PackedState& other) const
+  {
+    return memcmp(m_bytes, other.m_bytes, sizeof(m_bytes)) == 0;
+  }
+
+  bool PackedState::operator!=(const PackedState& other) const
+  {
+    return !(*this == other);
+  }
+
+  bool PackedState::operator<(const PackedState& other) const
+  {
+    return memcmp(m_bytes, other.m_bytes, sizeof(m_bytes)) < 0;
+  }
+
+  // Write the encoding to a queue page
+  void PackedState::QueueEncoding::encode(const PackedState& state, std::string& out)
+  {
+    out.append((const char*)state.bytes(), fixed_size);
+  }
+
+  // Read the encoding from a queue page
+  const char* PackedState::QueueEncoding::decode(const char* begin, const char* end,
+    PackedState& state)
+  {
+    if ((size_t)(end - begin) < fixed_size) {
+      return nullptr;
+    }
+    state = PackedState::from_bytes((const unsigned char*)begin);
+    return begin + fixed_size;
+  }
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <string>
+#include <cstddef>
+#include <functional>
+
+namespace Megaminx {
+
+  // Predeclarations
+  class MegaminxState;
+
+  /**
+   * Compact binary encoding of a MegaminxState
+   *
+   * Each facet is stored in 4 bits as its colour index plus one, two
+   * facets to a byte with the even facet in the low nibble, giving 60
+   * bytes in total. This byte layout is stable and can be written to
+   * disk as it is. Because no nibble is zero the bytes never contain a
+   * NUL so they can also be used directly as a string key.
+   */
+  class PackedState {
+    public:
+      // Number of bytes in the encoding
+      static const int num_bytes = 60;
+
+      // Constructor
+      // Initialise to the solved state
+      PackedState();
+
+      /**
+       * Pack a state
+       * Throws a Megaminx::invalid_state if a facet is not one of colours[]
+       * @param state The state to pack
+       */
+      explicit PackedState(const MegaminxState& state);
+
+      // Unpack to a full state
+      MegaminxState unpack() const;
+
+      // The encoded bytes
+      const unsigned char* bytes() const;
+
+      /**
+       * Construct from encoded bytes
+       * Throws a Megaminx::invalid_state if the bytes are not a valid encoding
+       * @param bytes num_bytes of encoded state
+       */
+      static PackedState from_bytes(const unsigned char* bytes);
+
+      // Return the encoding as a string for use as a key
+      std::string key() const;
+
+      /**
+       * Construct from a string returned by key()
+       * Throws a Megaminx::invalid_state if the key is not a valid encoding
+       * @param key The key
+       */
+      static PackedState from_key(const std::string& key);
+
+      // Return a hash of the encoding
+      size_t hash() const;
+
+      // Comparison is byte by byte so ordering is stable across platforms
+      bool operator==(const PackedState& other) const;
+      bool operator!=(const PackedState& other) const;
+      bool operator<(const PackedState& other) const;
+
+      // How packed states are written to a Utils::FilePagedQueue
+      // Just the num_bytes of encoding without the padding
+      struct QueueEncoding {
+        enum : size_t { fixed_size = num_bytes };
+        static void encode(const PackedState& state, std::string& out);
+        static const char* decode(const char* begin, const char* end, PackedState& state);
+      };
+
+    protected:
+    private:
+      // Padded to a whole number of words so comparisons and hashing can
+      // work a word at a time. The padding is always zero.
+      alignas(8) unsigned char m_bytes[64];
+  };
+
+}
+
+namespace std {
+  template<>
+  struct hash<Megaminx::PackedState> {
+    size_t operator()(const Megaminx::PackedState& state) const
+    {
+      return state.hash();
+    }
+  };
+}
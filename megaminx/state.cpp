@@ -0,0 +1,217 @@
+#include "state.h"
+#include "megaminx.h"
+#include "turn_kernel.h"
+#include <assert.h>
+#include <algorithm>
+#include <type_traits>
+#include "exceptions.h"
+
+namespace Megaminx {
+
+  // The whole point of the state is that it is cheap to copy
+  static_assert(std::is_trivially_copyable<MegaminxState>::value,
+    "MegaminxState must be trivially copyable");
+
+  // Masks have one bit per facet
+  static_assert(FacetMask().size() == MegaminxState::num_facets,
+    "FacetMask must have a bit for every facet");
+
+  // Constructor
+  MegaminxState::MegaminxState()
+  {
+    for (int i=0;i<num_faces;++i) {
+      std::fill_n(face_facets(i), facets_per_face, colours[i]);
+    }
+  }
+
+  // Return an individual facet
+  char MegaminxState::facet(int face, int i) const
+  {
+    assert(face >= 0 && face < num_faces);
+    assert(i >= 0 && i < facets_per_face);
+    return m_facets[face * facets_per_face + i];
+  }
+
+  // Set an individual facet
+  void MegaminxState::set_facet(int face, int i, char c)
+  {
+    assert(face >= 0 && face < num_faces);
+    assert(i >= 0 && i < facets_per_face);
+    m_facets[face * facets_per_face + i] = c;
+  }
+
+  // Return the facets of a face
+  char* MegaminxState::face_facets(int face)
+  {
+    assert(face >= 0 && face < num_faces);
+    return m_facets.data() + face * facets_per_face;
+  }
+
+  const char* MegaminxState::face_facets(int face) const
+  {
+    assert(face >= 0 && face < num_faces);
+    return m_facets.data() + face * facets_per_face;
+  }
+
+  char* MegaminxState::data()
+  {
+    return m_facets.data();
+  }
+
+  const char* MegaminxState::data() const
+  {
+    return m_facets.data();
+  }
+
+  // Return string representation of the state
+  std::string MegaminxState::str() const
+  {
+    std::string result;
+    result.reserve(num_facets);
+    for (int i=0;i<num_faces;++i) {
+      append_face_str(result, face_facets(i));
+    }
+    return result;
+  }
+
+  void MegaminxState::parse(const std::string& string)
+  {
+    // Parse into a copy so a failed parse leaves the state untouched
+    std::array<char,num_facets> facets;
+    auto pos = string.begin();
+    for (int i=0; i<num_faces; ++i) {
+      if (pos == string.end()) {
+        throw parse_error("String does not contain all faces");
+      }
+      int len = (*pos == '[') ? 3 : facets_per_face;
+      if (std::distance(pos,string.end()) < len) {
+        throw parse_error("String not long enough");
+      }
+      parse_face(std::string(pos, pos+len), facets.data() + i * facets_per_face);
+      pos += len;
+    }
+    m_facets = facets;
+  }
+
+  // Return if the puzzle is solved
+  bool MegaminxState::is_solved() const
+  {
+    return *this == MegaminxState();
+  }
+
+  // Return the compact encoding
+  PackedState MegaminxState::pack() const
+  {
+    return PackedState(*this);
+  }
+
+  // Set from the compact encoding
+  void MegaminxState::unpack(const PackedState& packed)
+  {
+    *this = packed.unpack();
+  }
+
+  // Apply a move
+  void MegaminxState::turn(Move m)
+  {
+    assert(m >= 0 && m < num_moves);
+    turn_facets(m_facets.data(), m);
+  }
+
+  // Turn a face
+  void MegaminxState::turn(int face, bool clockwise)
+  {
+    assert(face >= 0 && face < num_faces);
+    turn(make_move(face, clockwise));
+  }
+
+  // Take back a move
+  void MegaminxState::undo_move(Move m)
+  {
+    assert(m >= 0 && m < num_moves);
+    turn_facets(m_facets.data(), inverse_move(m));
+  }
+
+  // Compare the facets in a mask
+  bool MegaminxState::matches(const MegaminxState& other, const FacetMask& mask) const
+  {
+    for (int i=0;i<num_facets;++i) {
+      if (m_facets[i] != other.m_facets[i] && mask[i]) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Count the differing facets in a mask
+  int MegaminxState::mismatches(const MegaminxState& other, const FacetMask& mask) const
+  {
+    int count = 0;
+    for (int i=0;i<num_facets;++i) {
+      if (m_facets[i] != other.m_facets[i] && mask[i]) {
+        ++count;
+      }
+    }
+    return count;
+  }
+
+  bool MegaminxState::operator==(const MegaminxState& other) const
+  {
+    return m_facets == other.m_facets;
+  }
+
+  bool MegaminxState::operator!=(const MegaminxState& other) const
+  {
+    return m_facets != other.m_facets;
+  }
+
+  // Append the string representation of a face
+  void MegaminxState::append_face_str(std::string& out, const char* facets)
+  {
+    if (std::all_of(facets+1, facets+facets_per_face,
+      [facets](char c) { return c == facets[0]; }
+    )) {
+      // All facets are the same. Use shorthand notation
+      out += '[';
+      out += facets[0];
+      out += ']';
+    } else {
+      out.append(facets, facets_per_face);
+    }
+  }
+
+  // Parse a face from its string representation
+  void MegaminxState::parse_face(const std::string& string, char* facets)
+  {
+    if (string.size() == 3) {
+      if (string[0] != '[' || string[2] != ']') {
+        std::string message("Invalid string format for parse: ");
+        throw parse_error(message + string);
+      }
+      std::fill_n(facets, facets_per_face, string[1]);
+    } else if (string.size() == facets_per_face) {
+      std::copy(string.begin(),string.end(),facets);
+    } else {
+      std::string message("Invalid string length for parse: ");
+      throw parse_error(message + string);
+    }
+  }
+
+  // Write the packed state to a queue page
+  void MegaminxState::QueueEncoding::encode(const MegaminxState& state, std::string& out)
+  {
+    PackedState::QueueEncoding::encode(PackedState(state), out);
+  }
+
+  // Read the packed state from a queue page
+  const char* MegaminxState::QueueEncoding::decode(const char* begin, const char* end,
+    MegaminxState& state)
+  {
+    PackedState packed;
+    const char* next = PackedState::QueueEncoding::decode(begin, end, packed);
+    if (next) {
+      state = packed.unpack();
+    }
+    return next;
+  }
+}
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <string>
+#include <array>
+#include "moves.h"
+#include "packed.h"
+#include "facet_mask.h"
+
+namespace Megaminx {
+
+  /**
+   * Flat value type holding the complete state of the puzzle
+   *
+   * All 120 facets are held in one contiguous array, ten per face in the
+   * same order as the colours[] table. The type is trivially copyable so
+   * copying a state is a single 120 byte copy with no allocation.
+   * Face and Megaminx objects act as views over a state.
+   */
+  class MegaminxState {
+    public:
+      // Number of faces and facets in the puzzle
+      static const int num_faces = 12;
+      static const int facets_per_face = 10;
+      static const int num_facets = num_faces * facets_per_face;
+
+      // Constructor
+      // Initialise to the solved state
+      MegaminxState();
+
+      /**
+       * Return a facet of the puzzle
+       * @param face The face index 0 -> 11
+       * @param i The facet on that face 0 -> 9
+       */
+      char facet(int face, int i) const;
+
+      /**
+       * Set a facet of the puzzle
+       * @param face The face index 0 -> 11
+       * @param i The facet on that face 0 -> 9
+       * @param c The colour to set
+       */
+      void set_facet(int face, int i, char c);
+
+      /**
+       * Return a pointer to the ten facets of a face
+       * @param face The face index 0 -> 11
+       */
+      char* face_facets(int face);
+      const char* face_facets(int face) const;
+
+      // Direct access to all facets
+      char* data();
+      const char* data() const;
+
+      // Return string representation of the state
+      // This is the same format as Megaminx::str()
+      std::string str() const;
+
+      // Parse the state from the string representation
+      void parse(const std::string& string);
+
+      // Return if the puzzle is solved
+      bool is_solved() const;
+
+      // Return the compact encoding of the state
+      PackedState pack() const;
+
+      // Set the state from its compact encoding
+      void unpack(const PackedState& packed);
+
+      /**
+       * Apply a move to the state in place
+       * Uses the fastest turn kernel this CPU supports. Together with
+       * undo_move() this lets a depth first search walk the tree on a
+       * single state without copying it at each node
+       * @param m The move 0 -> 23
+       */
+      void turn(Move m);
+
+      /**
+       * Turn a face of the puzzle
+       * @param face The face index 0 -> 11
+       * @param clockwise The direction of the turn
+       */
+      void turn(int face, bool clockwise);
+
+      /**
+       * Take back a move made with turn()
+       * @param m The move that was made 0 -> 23
+       */
+      void undo_move(Move m);
+
+      /**
+       * Return if the facets in a mask are the same as another state
+       * Used to test for part of the puzzle being solved
+       * @param other The state to compare with
+       * @param mask The facets to compare
+       */
+      bool matches(const MegaminxState& other, const FacetMask& mask) const;
+
+      /**
+       * Return the number of facets in a mask that differ from another state
+       * @param other The state to compare with
+       * @param mask The facets to compare
+       */
+      int mismatches(const MegaminxState& other, const FacetMask& mask) const;
+
+      bool operator==(const MegaminxState& other) const;
+      bool operator!=(const MegaminxState& other) const;
+
+      /**
+       * Append the string representation of the ten facets of a face
+       * Uses the shorthand [c] if all facets are the same
+       * @param out The string to append to
+       * @param facets The ten facets
+       */
+      static void append_face_str(std::string& out, const char* facets);
+
+      /**
+       * Parse the ten facets of a face from its string representation
+       * Throws a Megaminx::parse_error if the string is not valid
+       * @param string Either "[c]" or ten facet characters
+       * @param facets The ten facets to set
+       */
+      static void parse_face(const std::string& string, char* facets);
+
+      // How states are written to a Utils::FilePagedQueue
+      // In their packed form rather than as all the facets
+      struct QueueEncoding {
+        enum : size_t { fixed_size = PackedState::num_bytes };
+        static void encode(const MegaminxState& state, std::string& out);
+        static const char* decode(const char* begin, const char* end, MegaminxState& state);
+      };
+
+    protected:
+    private:
+      // The facets of all the faces
+      std::array<char,num_facets> m_facets;
+  };
+
+}
@@ -0,0 +1,162 @@
+#include "state_block.h"
+#include "state.h"
+#include "algorithm.h"
+#include <assert.h>
+#include <string.h>
+#include <algorithm>
+
+namespace Megaminx {
+
+  namespace {
+    const int num_facets = MegaminxState::num_facets;
+
+    // Rows are padded to whole cache lines
+    size_t row_stride(size_t capacity)
+    {
+      return (capacity + 63) & ~(size_t)63;
+    }
+  }
+
+  // Constructor
+  StateBlock::StateBlock(size_t capacity)
+    : m_size(0),
+      m_stride(row_stride(capacity)),
+      m_facets(num_facets * m_stride)
+  {
+  }
+
+  size_t StateBlock::size() const
+  {
+    return m_size;
+  }
+
+  bool StateBlock::empty() const
+  {
+    return m_size == 0;
+  }
+
+  void StateBlock::clear()
+  {
+    m_size = 0;
+  }
+
+  // Make room for more states
+  void StateBlock::reserve(size_t capacity)
+  {
+    if (capacity <= m_stride) {
+      return;
+    }
+    size_t stride = row_stride(capacity);
+    std::vector<char> facets(num_facets * stride);
+    if (m_size > 0) {
+      for (int f=0;f<num_facets;++f) {
+        memcpy(facets.data() + f * stride, row(f), m_size);
+      }
+    }
+    m_facets.swap(facets);
+    m_stride = stride;
+  }
+
+  // Add a state
+  void StateBlock::push_back(const MegaminxState& state)
+  {
+    if (m_size == m_stride) {
+      reserve(std::max<size_t>(64, m_stride * 2));
+    }
+    const char* facets = state.data();
+    for (int f=0;f<num_facets;++f) {
+      writable_row(f)[m_size] = facets[f];
+    }
+    ++m_size;
+  }
+
+  // Return a state
+  MegaminxState StateBlock::state(size_t i) const
+  {
+    assert(i < m_size);
+    MegaminxState result;
+    char* facets = result.data();
+    for (int f=0;f<num_facets;++f) {
+      facets[f] = row(f)[i];
+    }
+    return result;
+  }
+
+  // Replace a state
+  void StateBlock::set_state(size_t i, const MegaminxState& state)
+  {
+    assert(i < m_size);
+    const char* facets = state.data();
+    for (int f=0;f<num_facets;++f) {
+      writable_row(f)[i] = facets[f];
+    }
+  }
+
+  const char* StateBlock::row(int facet) const
+  {
+    assert(facet >= 0 && facet < num_facets);
+    return m_facets.data() + facet * m_stride;
+  }
+
+  char* StateBlock::writable_row(int facet)
+  {
+    assert(facet >= 0 && facet < num_facets);
+    return m_facets.data() + facet * m_stride;
+  }
+
+  // Apply a move
+  void StateBlock::turn(Move m)
+  {
+    assert(m >= 0 && m < num_moves);
+    permute(move_permutation(m));
+  }
+
+  // Apply an algorithm
+  void StateBlock::apply(const Algorithm& algorithm)
+  {
+    permute(algorithm.permutation());
+  }
+
+  // Apply any permutation
+  void StateBlock::permute(const unsigned char* from)
+  {
+    if (m_size == 0) {
+      return;
+    }
+    // Only the rows that change need to be copied. They are saved first
+    // as each one may be the source of another
+    int moved[num_facets];
+    int saved_at[num_facets];
+    int count = 0;
+    for (int f=0;f<num_facets;++f) {
+      if (from[f] != f) {
+        saved_at[f] = count;
+        moved[count++] = f;
+      }
+    }
+    std::vector<char> saved(count * m_size);
+    for (int i=0;i<count;++i) {
+      memcpy(saved.data() + i * m_size, row(moved[i]), m_size);
+    }
+    for (int i=0;i<count;++i) {
+      int f = moved[i];
+      memcpy(writable_row(f), saved.data() + saved_at[from[f]] * m_size, m_size);
+    }
+  }
+
+  // Return a turned copy
+  StateBlock StateBlock::turned(Move m) const
+  {
+    assert(m >= 0 && m < num_moves);
+    const unsigned char* from = move_permutation(m);
+    StateBlock result(m_size);
+    if (m_size == 0) {
+      return result;
+    }
+    for (int f=0;f<num_facets;++f) {
+      memcpy(result.writable_row(f), row(from[f]), m_size);
+    }
+    result.m_size = m_size;
+    return result;
+  }
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include "moves.h"
+
+namespace Megaminx {
+
+  // Predeclarations
+  class MegaminxState;
+  class Algorithm;
+
+  /**
+   * A block of states held structure-of-arrays
+   *
+   * Facet f of every state is held together in one row, so applying a
+   * move to the whole block is a copy of each row the move changes.
+   * Rows the move does not touch are left alone. The row copies run over
+   * contiguous memory so the compiler and memcpy vectorise them.
+   */
+  class StateBlock {
+    public:
+      // Constructor
+      // Room is reserved for capacity states
+      explicit StateBlock(size_t capacity = 0);
+
+      // Number of states in the block
+      size_t size() const;
+
+      // Return if the block holds no states
+      bool empty() const;
+
+      // Remove all states
+      void clear();
+
+      // Make room for at least capacity states
+      void reserve(size_t capacity);
+
+      // Add a state to the end of the block
+      void push_back(const MegaminxState& state);
+
+      /**
+       * Return a state from the block
+       * @param i The index of the state 0 -> size()-1
+       */
+      MegaminxState state(size_t i) const;
+
+      /**
+       * Replace a state in the block
+       * @param i The index of the state 0 -> size()-1
+       * @param state The new state
+       */
+      void set_state(size_t i, const MegaminxState& state);
+
+      /**
+       * Return one facet of every state in the block
+       * @param facet The facet 0 -> 119
+       */
+      const char* row(int facet) const;
+
+      // Apply a move to every state
+      void turn(Move m);
+
+      // Apply an algorithm to every state
+      void apply(const Algorithm& algorithm);
+
+      /**
+       * Return a copy of the block with a move applied to every state
+       * This does the copy and move in one pass so is the quickest way
+       * to generate the children of a block for each move
+       * @param m The move
+       */
+      StateBlock turned(Move m) const;
+
+    protected:
+    private:
+      char* writable_row(int facet);
+
+      // Apply any facet permutation to every state
+      void permute(const unsigned char* from);
+
+      size_t m_size;
+      size_t m_stride;
+      std::vector<char> m_facets;
+  };
+
+}
@@ -0,0 +1,201 @@
+#include "symmetry.h"
+#include "megaminx.h"
+#include "state.h"
+#include <assert.h>
+
+namespace Megaminx {
+
+  namespace {
+    const int num_facets = MegaminxState::num_facets;
+
+    // Everything needed to apply each symmetry
+    struct SymmetryTables {
+      unsigned char face[num_symmetries][12];
+      unsigned char from[num_symmetries][num_facets];
+      unsigned char recolour[num_symmetries][256];
+      unsigned char move[num_symmetries][num_moves];
+      unsigned char inverse[num_symmetries];
+    };
+
+    /**
+     * Work out where a symmetry takes each face and each edge of each face
+     * The symmetry is fixed by where edge 0 of face 0 goes. Every other
+     * face follows by walking the connections from there. A reflection
+     * runs round the edges of each face the other way.
+     * @param s The symmetry
+     * @param face Set to the face each face goes to
+     * @param edge Set to the edge each edge of each face goes to
+     */
+    void map_faces(int s, unsigned char face[12], int edge[12][5])
+    {
+      bool reflect = s >= num_rotations;
+      int r = s % num_rotations;
+      bool done[12] = {};
+      int queue[12];
+      int queued = 0;
+      face[0] = (unsigned char)(r / 5);
+      for (int e=0;e<5;++e) {
+        edge[0][e] = reflect ? (r % 5 - e + 5) % 5 : (r % 5 + e) % 5;
+      }
+      done[0] = true;
+      queue[queued++] = 0;
+      for (int q=0;q<queued;++q) {
+        int a = queue[q];
+        for (int e=0;e<5;++e) {
+          int n = face_index(connections[a][e]);
+          int image = face_index(connections[face[a]][edge[a][e]]);
+          if (done[n]) {
+            assert(face[n] == image);
+            continue;
+          }
+          face[n] = (unsigned char)image;
+          int back = connecting_edge(n, a);
+          int image_back = connecting_edge(image, face[a]);
+          for (int x=0;x<5;++x) {
+            int offset = x - back + 5;
+            edge[n][x] = reflect ? (image_back - offset + 10) % 5 : (image_back + offset) % 5;
+          }
+          done[n] = true;
+          queue[queued++] = n;
+        }
+      }
+      assert(queued == 12);
+    }
+
+    void build_symmetry(SymmetryTables& tables, int s)
+    {
+      bool reflect = s >= num_rotations;
+      int edge[12][5];
+      unsigned char* face = tables.face[s];
+      map_faces(s, face, edge);
+
+      // Edge facets stay in the middle of their edge. Corner facets sit at
+      // the start of an edge, which becomes the end under a reflection
+      unsigned char* from = tables.from[s];
+      for (int a=0;a<12;++a) {
+        for (int i=0;i<10;++i) {
+          int e = i / 2;
+          int to = edge[a][e] * 2 + ((i % 2) ? 1 : (reflect ? 2 : 0));
+          from[face[a] * 10 + to % 10] = (unsigned char)(a * 10 + i);
+        }
+      }
+
+      // Relabel colours so the face centres stay put
+      // Anything that is not a colour is left alone
+      unsigned char* recolour = tables.recolour[s];
+      for (int c=0;c<256;++c) {
+        recolour[c] = (unsigned char)c;
+      }
+      for (int a=0;a<12;++a) {
+        recolour[(unsigned char)colours[a]] = (unsigned char)colours[face[a]];
+      }
+
+      for (int m=0;m<num_moves;++m) {
+        bool clockwise = move_clockwise(m) != reflect;
+        tables.move[s][m] = (unsigned char)make_move(face[move_face(m)], clockwise);
+      }
+    }
+
+    SymmetryTables build_symmetry_tables()
+    {
+      SymmetryTables tables;
+      for (int s=0;s<num_symmetries;++s) {
+        build_symmetry(tables, s);
+      }
+      // The inverse puts every facet back where it started
+      for (int s=0;s<num_symmetries;++s) {
+        for (int t=0;t<num_symmetries;++t) {
+          bool identity = true;
+          for (int i=0;i<num_facets && identity;++i) {
+            identity = tables.from[s][tables.from[t][i]] == i;
+          }
+          if (identity) {
+            tables.inverse[s] = (unsigned char)t;
+            break;
+          }
+        }
+      }
+      return tables;
+    }
+
+    const SymmetryTables& symmetry_tables()
+    {
+      static const SymmetryTables tables = build_symmetry_tables();
+      return tables;
+    }
+  }
+
+  // Return where a symmetry takes a face
+  int symmetry_face(int s, int face)
+  {
+    assert(s >= 0 && s < num_symmetries);
+    assert(face >= 0 && face < 12);
+    return symmetry_tables().face[s][face];
+  }
+
+  // Return the equivalent move after a symmetry
+  Move symmetry_move(int s, Move m)
+  {
+    assert(s >= 0 && s < num_symmetries);
+    assert(m >= 0 && m < num_moves);
+    return symmetry_tables().move[s][m];
+  }
+
+  // Return the inverse of a symmetry
+  int inverse_symmetry(int s)
+  {
+    assert(s >= 0 && s < num_symmetries);
+    return symmetry_tables().inverse[s];
+  }
+
+  // Apply a symmetry to a state
+  MegaminxState apply_symmetry(const MegaminxState& state, int s)
+  {
+    assert(s >= 0 && s < num_symmetries);
+    const SymmetryTables& tables = symmetry_tables();
+    const unsigned char* from = tables.from[s];
+    const unsigned char* recolour = tables.recolour[s];
+    const char* facets = state.data();
+    MegaminxState result;
+    char* out = result.data();
+    for (int i=0;i<num_facets;++i) {
+      out[i] = (char)recolour[(unsigned char)facets[from[i]]];
+    }
+    return result;
+  }
+
+  // Return the smallest symmetric state
+  MegaminxState canonical_state(const MegaminxState& state,
+    bool reflections, int* which)
+  {
+    const SymmetryTables& tables = symmetry_tables();
+    const char* facets = state.data();
+    MegaminxState best(state);
+    unsigned char* out = (unsigned char*)best.data();
+    int best_symmetry = 0;
+    int count = reflections ? num_symmetries : num_rotations;
+    for (int s=1;s<count;++s) {
+      const unsigned char* from = tables.from[s];
+      const unsigned char* recolour = tables.recolour[s];
+      // Most candidates differ from the best within the first few facets
+      // so each is only built as far as it needs to be compared
+      for (int i=0;i<num_facets;++i) {
+        unsigned char c = recolour[(unsigned char)facets[from[i]]];
+        if (c > out[i]) {
+          break;
+        }
+        if (c < out[i]) {
+          for (;i<num_facets;++i) {
+            out[i] = recolour[(unsigned char)facets[from[i]]];
+          }
+          best_symmetry = s;
+          break;
+        }
+      }
+    }
+    if (which) {
+      *which = best_symmetry;
+    }
+    return best;
+  }
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "moves.h"
+
+namespace Megaminx {
+
+  // Predeclarations
+  class MegaminxState;
+
+  // Number of whole puzzle rotations of the dodecahedron
+  const int num_rotations = 60;
+
+  // Number of symmetries including reflections
+  // Symmetries 0 -> 59 are rotations, 60 -> 119 are reflections
+  // Symmetry 0 is the identity
+  const int num_symmetries = 120;
+
+  /**
+   * Return the face a symmetry takes a face to
+   * @param s The symmetry 0 -> 119
+   * @param face The face index 0 -> 11
+   */
+  int symmetry_face(int s, int face);
+
+  /**
+   * Return the move that does the same thing after a symmetry is applied
+   * Reflections turn clockwise moves into anticlockwise ones
+   * so that apply_symmetry(turn(state, m), s) ==
+   * turn(apply_symmetry(state, s), symmetry_move(s, m))
+   * @param s The symmetry 0 -> 119
+   * @param m The move
+   */
+  Move symmetry_move(int s, Move m);
+
+  // Return the symmetry that undoes a symmetry
+  int inverse_symmetry(int s);
+
+  /**
+   * Apply a symmetry to a state
+   * The facets are moved as if the whole puzzle were rotated (or
+   * reflected) and the colours are relabelled so the face centres are
+   * back where they started.
+   * @param state The state
+   * @param s The symmetry 0 -> 119
+   */
+  MegaminxState apply_symmetry(const MegaminxState& state, int s);
+
+  /**
+   * Return the unique representative of a state under symmetry
+   * This is the lexicographically smallest of the symmetric states
+   * @param state The state
+   * @param reflections Include the 60 reflections as well as rotations
+   * @param which If not null set to the symmetry that gives the result
+   */
+  MegaminxState canonical_state(const MegaminxState& state,
+    bool reflections = false, int* which = nullptr);
+}
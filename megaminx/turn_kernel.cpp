@@ -0,0 +1,370 @@
+#include "turn_kernel.h"
+#include "moves.h"
+#include <assert.h>
+#include <algorithm>
+#include <array>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define MEGAMINX_X86
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+// Allow individual functions to use instruction sets beyond the
+// compiler's baseline. MSVC allows any intrinsic so needs nothing.
+#if defined(_MSC_VER) && !defined(__clang__)
+#define TARGET(x)
+#else
+#define TARGET(x) __attribute__((target(x)))
+#endif
+
+namespace Megaminx {
+
+  namespace {
+    const int num_facets = 120;
+
+    typedef void (*TurnFunction)(char*, Move);
+
+    typedef void (*PermuteFunction)(char*, const unsigned char*);
+
+    //----- Scalar kernel
+    void permute_scalar(char* facets, const unsigned char* from)
+    {
+      char before[num_facets];
+      std::copy(facets, facets+num_facets, before);
+      for (int i=0;i<num_facets;++i) {
+        facets[i] = before[from[i]];
+      }
+    }
+
+    void turn_scalar(char* facets, Move m)
+    {
+      permute_scalar(facets, move_permutation(m));
+    }
+
+#ifdef MEGAMINX_X86
+    //----- Shuffle tables for the pshufb kernels
+    // The state is loaded as eight 16 byte chunks. The last chunk
+    // overlaps the one before so nothing is read or written past the
+    // end of the 120 facets.
+    const int num_chunks = 8;
+    const int chunk_offset[num_chunks] = {0,16,32,48,64,80,96,104};
+
+    // Output blocks for the 32 byte kernel, overlapping in the same way
+    const int num_blocks = 4;
+    const int block_offset[num_blocks] = {0,32,64,88};
+
+    // One shuffle of an input chunk into part of an output block
+    struct ShuffleStep {
+      int out;
+      int in;
+      unsigned char mask[32];
+    };
+
+    // The shuffles needed for a move
+    // Output blocks that the move does not change are skipped entirely
+    struct ShuffleTable {
+      std::vector<ShuffleStep> steps;
+    };
+
+    bool in_chunk(int facet, int chunk)
+    {
+      return facet >= chunk_offset[chunk] && facet < chunk_offset[chunk] + 16;
+    }
+
+    // Work out the shuffles to build output blocks of the given width
+    ShuffleTable build_shuffle_table(Move m, int width, const int* offsets, int count)
+    {
+      const unsigned char* from = move_permutation(m);
+      ShuffleTable table;
+      for (int out=0;out<count;++out) {
+        int offset = offsets[out];
+        bool changed = false;
+        for (int i=0;i<width;++i) {
+          changed = changed || from[offset+i] != offset+i;
+        }
+        if (!changed) {
+          continue;
+        }
+        size_t first = table.steps.size();
+        for (int i=0;i<width;++i) {
+          int facet = from[offset+i];
+          // Prefer a chunk this block already shuffles from
+          size_t step = first;
+          while (step < table.steps.size() && !in_chunk(facet,table.steps[step].in)) {
+            ++step;
+          }
+          if (step == table.steps.size()) {
+            ShuffleStep s;
+            s.out = out;
+            s.in = (facet < 112) ? facet / 16 : num_chunks - 1;
+            // High bit set gives zero so steps can be or'ed together
+            std::fill(s.mask, s.mask+32, (unsigned char)0x80);
+            table.steps.push_back(s);
+          }
+          ShuffleStep& s = table.steps[step];
+          s.mask[i] = (unsigned char)(facet - chunk_offset[s.in]);
+        }
+      }
+      return table;
+    }
+
+    const std::array<ShuffleTable,num_moves>& shuffle_tables_16()
+    {
+      static const std::array<ShuffleTable,num_moves> tables = [] {
+        std::array<ShuffleTable,num_moves> t;
+        for (Move m=0;m<num_moves;++m) {
+          t[m] = build_shuffle_table(m, 16, chunk_offset, num_chunks);
+        }
+        return t;
+      }();
+      return tables;
+    }
+
+    const std::array<ShuffleTable,num_moves>& shuffle_tables_32()
+    {
+      static const std::array<ShuffleTable,num_moves> tables = [] {
+        std::array<ShuffleTable,num_moves> t;
+        for (Move m=0;m<num_moves;++m) {
+          t[m] = build_shuffle_table(m, 32, block_offset, num_blocks);
+        }
+        return t;
+      }();
+      return tables;
+    }
+
+    // Index tables for vpermi2b padded out to the full 128 bytes
+    struct PermuteTable {
+      unsigned char index[128];
+    };
+
+    const std::array<PermuteTable,num_moves>& permute_tables()
+    {
+      static const std::array<PermuteTable,num_moves> tables = [] {
+        std::array<PermuteTable,num_moves> t;
+        for (Move m=0;m<num_moves;++m) {
+          const unsigned char* from = move_permutation(m);
+          std::copy(from, from+num_facets, t[m].index);
+          std::fill(t[m].index+num_facets, t[m].index+128, (unsigned char)0);
+        }
+        return t;
+      }();
+      return tables;
+    }
+
+    //----- SSE4.1 kernel
+    TARGET("sse4.1")
+    void turn_sse41(char* facets, Move m)
+    {
+      const ShuffleTable& table = shuffle_tables_16()[m];
+      __m128i in[num_chunks];
+      for (int c=0;c<num_chunks;++c) {
+        in[c] = _mm_loadu_si128((const __m128i*)(facets + chunk_offset[c]));
+      }
+      auto step = table.steps.begin();
+      auto end = table.steps.end();
+      while (step != end) {
+        int out = step->out;
+        __m128i result = _mm_setzero_si128();
+        for (; step != end && step->out == out; ++step) {
+          __m128i mask = _mm_loadu_si128((const __m128i*)step->mask);
+          result = _mm_or_si128(result, _mm_shuffle_epi8(in[step->in], mask));
+        }
+        _mm_storeu_si128((__m128i*)(facets + chunk_offset[out]), result);
+      }
+    }
+
+    //----- AVX2 kernel
+    TARGET("avx2")
+    void turn_avx2(char* facets, Move m)
+    {
+      const ShuffleTable& table = shuffle_tables_32()[m];
+      // vpshufb works within 16 byte lanes so each chunk is
+      // broadcast to both lanes
+      __m256i in[num_chunks];
+      for (int c=0;c<num_chunks;++c) {
+        in[c] = _mm256_broadcastsi128_si256(
+          _mm_loadu_si128((const __m128i*)(facets + chunk_offset[c])));
+      }
+      auto step = table.steps.begin();
+      auto end = table.steps.end();
+      while (step != end) {
+        int out = step->out;
+        __m256i result = _mm256_setzero_si256();
+        for (; step != end && step->out == out; ++step) {
+          __m256i mask = _mm256_loadu_si256((const __m256i*)step->mask);
+          result = _mm256_or_si256(result, _mm256_shuffle_epi8(in[step->in], mask));
+        }
+        _mm256_storeu_si256((__m256i*)(facets + block_offset[out]), result);
+      }
+    }
+
+    //----- AVX-512 VBMI kernel
+    // The whole state fits in two registers which vpermi2b treats as
+    // one 128 byte table, so a move is just two permutes
+    TARGET("avx512f,avx512bw,avx512vbmi")
+    void permute_avx512vbmi(char* facets, const unsigned char* from)
+    {
+      const __mmask64 tail = (1ULL << (num_facets - 64)) - 1;
+      __m512i lo = _mm512_loadu_si512(facets);
+      __m512i hi = _mm512_maskz_loadu_epi8(tail, facets + 64);
+      __m512i index_lo = _mm512_loadu_si512(from);
+      __m512i index_hi = _mm512_maskz_loadu_epi8(tail, from + 64);
+      __m512i out_lo = _mm512_permutex2var_epi8(lo, index_lo, hi);
+      __m512i out_hi = _mm512_permutex2var_epi8(lo, index_hi, hi);
+      _mm512_storeu_si512(facets, out_lo);
+      _mm512_mask_storeu_epi8(facets + 64, tail, out_hi);
+    }
+
+    TARGET("avx512f,avx512bw,avx512vbmi")
+    void turn_avx512vbmi(char* facets, Move m)
+    {
+      permute_avx512vbmi(facets, permute_tables()[m].index);
+    }
+
+    //----- CPU feature detection
+#if defined(_MSC_VER) && !defined(__clang__)
+    struct CpuFeatures {
+      bool sse41;
+      bool avx2;
+      bool avx512vbmi;
+    };
+
+    CpuFeatures detect_features()
+    {
+      CpuFeatures features = {false, false, false};
+      int info[4];
+      __cpuid(info, 0);
+      int max_leaf = info[0];
+      __cpuid(info, 1);
+      features.sse41 = (info[2] & (1 << 19)) != 0;
+      bool osxsave = (info[2] & (1 << 27)) != 0;
+      if (!osxsave || max_leaf < 7) {
+        return features;
+      }
+      // Check the OS saves the wider registers
+      unsigned long long xcr0 = _xgetbv(0);
+      bool avx_os = (xcr0 & 0x6) == 0x6;
+      bool avx512_os = (xcr0 & 0xe6) == 0xe6;
+      __cpuidex(info, 7, 0);
+      features.avx2 = avx_os && (info[1] & (1 << 5)) != 0;
+      features.avx512vbmi = avx512_os &&
+        (info[1] & (1 << 16)) != 0 &&  // AVX512F
+        (info[1] & (1 << 30)) != 0 &&  // AVX512BW
+        (info[2] & (1 << 1)) != 0;     // AVX512VBMI
+      return features;
+    }
+
+    bool cpu_supports(TurnKernel kernel)
+    {
+      static const CpuFeatures features = detect_features();
+      switch (kernel) {
+        case TurnKernel::sse41: return features.sse41;
+        case TurnKernel::avx2: return features.avx2;
+        case TurnKernel::avx512vbmi: return features.avx512vbmi;
+        default: return true;
+      }
+    }
+#else
+    bool cpu_supports(TurnKernel kernel)
+    {
+      __builtin_cpu_init();
+      switch (kernel) {
+        case TurnKernel::sse41:
+          return __builtin_cpu_supports("sse4.1");
+        case TurnKernel::avx2:
+          return __builtin_cpu_supports("avx2");
+        case TurnKernel::avx512vbmi:
+          return __builtin_cpu_supports("avx512f") &&
+            __builtin_cpu_supports("avx512bw") &&
+            __builtin_cpu_supports("avx512vbmi");
+        default:
+          return true;
+      }
+    }
+#endif
+#endif // MEGAMINX_X86
+
+    TurnFunction kernel_function(TurnKernel kernel)
+    {
+      switch (kernel) {
+#ifdef MEGAMINX_X86
+        case TurnKernel::sse41: return turn_sse41;
+        case TurnKernel::avx2: return turn_avx2;
+        case TurnKernel::avx512vbmi: return turn_avx512vbmi;
+#endif
+        default: return turn_scalar;
+      }
+    }
+  }
+
+  // Return if the kernel can be used
+  bool turn_kernel_supported(TurnKernel kernel)
+  {
+    if (kernel == TurnKernel::scalar) {
+      return true;
+    }
+#ifdef MEGAMINX_X86
+    return cpu_supports(kernel);
+#else
+    return false;
+#endif
+  }
+
+  // Return the fastest supported kernel
+  TurnKernel best_turn_kernel()
+  {
+    const TurnKernel preference[] = {
+      TurnKernel::avx512vbmi,
+      TurnKernel::avx2,
+      TurnKernel::sse41
+    };
+    for (TurnKernel kernel : preference) {
+      if (turn_kernel_supported(kernel)) {
+        return kernel;
+      }
+    }
+    return TurnKernel::scalar;
+  }
+
+  // Return the name of a kernel
+  const char* turn_kernel_name(TurnKernel kernel)
+  {
+    switch (kernel) {
+      case TurnKernel::sse41: return "sse4.1";
+      case TurnKernel::avx2: return "avx2";
+      case TurnKernel::avx512vbmi: return "avx512vbmi";
+      default: return "scalar";
+    }
+  }
+
+  // Apply a move with a given kernel
+  void turn_facets(char* facets, Move m, TurnKernel kernel)
+  {
+    assert(m >= 0 && m < num_moves);
+    assert(turn_kernel_supported(kernel));
+    kernel_function(kernel)(facets, m);
+  }
+
+  // Apply a move with the best kernel
+  void turn_facets(char* facets, Move m)
+  {
+    assert(m >= 0 && m < num_moves);
+    static const TurnFunction best = kernel_function(best_turn_kernel());
+    best(facets, m);
+  }
+
+  // Apply any permutation
+  void permute_facets(char* facets, const unsigned char* from)
+  {
+    static const PermuteFunction best =
+#ifdef MEGAMINX_X86
+      turn_kernel_supported(TurnKernel::avx512vbmi) ? permute_avx512vbmi :
+#endif
+      permute_scalar;
+    best(facets, from);
+  }
+}
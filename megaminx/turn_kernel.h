@@ -0,0 +1,49 @@
+#pragma once
+
+#include "moves.h"
+
+namespace Megaminx {
+
+  // The implementations available for applying a move to the facets
+  enum class TurnKernel {
+    scalar,     // Plain gather through the move table
+    sse41,      // 16 byte pshufb shuffles
+    avx2,       // 32 byte vpshufb shuffles
+    avx512vbmi  // Two vpermi2b over the whole state
+  };
+
+  // Return if the kernel can be used on this CPU
+  bool turn_kernel_supported(TurnKernel kernel);
+
+  // Return the fastest kernel supported by this CPU
+  TurnKernel best_turn_kernel();
+
+  // Return the name of a kernel eg. "avx2"
+  const char* turn_kernel_name(TurnKernel kernel);
+
+  /**
+   * Apply a move to the 120 facets of a state with a given kernel
+   * The kernel must be supported by this CPU
+   * @param facets The facets of the state
+   * @param m The move 0 -> 23
+   * @param kernel The kernel to use
+   */
+  void turn_facets(char* facets, Move m, TurnKernel kernel);
+
+  /**
+   * Apply a move to the 120 facets of a state with the best kernel
+   * The choice is made once on first use
+   * @param facets The facets of the state
+   * @param m The move 0 -> 23
+   */
+  void turn_facets(char* facets, Move m);
+
+  /**
+   * Apply an arbitrary facet permutation to the 120 facets of a state
+   * Afterwards facet i holds what was at facet from[i] before.
+   * Uses vpermi2b if the CPU has AVX-512 VBMI otherwise a scalar gather.
+   * @param facets The facets of the state
+   * @param from The permutation, 120 entries
+   */
+  void permute_facets(char* facets, const unsigned char* from);
+}
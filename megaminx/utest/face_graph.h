@@ -0,0 +1,39 @@
+#pragma once
+
+#include "face.h"
+#include "state.h"
+#include "megaminx.h"
+#include <memory>
+#include <array>
+
+// Shared by the tests that check the state against the Face graph
+namespace {
+  typedef std::array<std::shared_ptr<Megaminx::Face>,12> FaceGraph;
+
+  // Build a standalone connected set of faces not backed by a state
+  // so rotations go through the original Face implementation
+  FaceGraph make_faces()
+  {
+    FaceGraph faces;
+    for (int i=0;i<12;++i) {
+      faces[i] = std::make_shared<Megaminx::Face>(Megaminx::colours[i]);
+    }
+    for (int i=0;i<12;++i) {
+      for (int j=0;j<5;++j) {
+        faces[i]->connect(j,faces[Megaminx::face_index(Megaminx::connections[i][j])]);
+      }
+    }
+    return faces;
+  }
+
+  // Give every facet a unique value in both the state and the faces
+  void label(Megaminx::MegaminxState& state, FaceGraph& faces)
+  {
+    for (int i=0;i<12;++i) {
+      for (int j=0;j<10;++j) {
+        state.set_facet(i,j,(char)(i*10+j));
+        faces[i]->set_facet(j,(char)(i*10+j));
+      }
+    }
+  }
+}
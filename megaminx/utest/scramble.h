@@ -0,0 +1,17 @@
+#pragma once
+
+#include "state.h"
+#include <stdlib.h>
+
+// Shared by the tests. Seed with srand() for a repeatable scramble
+namespace {
+  // Return a state after some random moves from solved
+  Megaminx::MegaminxState scramble(int moves)
+  {
+    Megaminx::MegaminxState state;
+    for (int i=0;i<moves;++i) {
+      state.turn(rand() % Megaminx::num_moves);
+    }
+    return state;
+  }
+}
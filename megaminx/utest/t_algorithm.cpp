@@ -0,0 +1,87 @@
+#include <gtest/gtest.h>
+#include "algorithm.h"
+#include "state.h"
+#include "megaminx.h"
+#include "face.h"
+#include "exceptions.h"
+#include <stdlib.h>
+
+TEST(AlgorithmTest,Constructor)
+{
+  Megaminx::Algorithm a;
+  EXPECT_TRUE(a.empty());
+  EXPECT_EQ(a.str(), "");
+  Megaminx::MegaminxState s;
+  a.apply(s);
+  EXPECT_TRUE(s.is_solved());
+}
+
+TEST(AlgorithmTest,parse)
+{
+  Megaminx::Algorithm a("x> Y< G>2");
+  ASSERT_EQ(a.size(), 4);
+  EXPECT_EQ(a.moves()[0], Megaminx::make_move(6,true));
+  EXPECT_EQ(a.moves()[1], Megaminx::make_move(4,false));
+  EXPECT_EQ(a.moves()[2], Megaminx::make_move(2,true));
+  EXPECT_EQ(a.moves()[3], Megaminx::make_move(2,true));
+  EXPECT_EQ(a.str(), "x> Y< G>2");
+  EXPECT_EQ(Megaminx::Algorithm(a.str()), a);
+
+  EXPECT_THROW(Megaminx::Algorithm("j>"), Megaminx::invalid_instruction);
+  EXPECT_THROW(Megaminx::Algorithm("x"), Megaminx::invalid_instruction);
+  EXPECT_THROW(Megaminx::Algorithm("x^"), Megaminx::invalid_instruction);
+  EXPECT_THROW(Megaminx::Algorithm("x>0"), Megaminx::invalid_instruction);
+}
+
+TEST(AlgorithmTest,matches_single_moves)
+{
+  srand(99);
+  std::vector<Megaminx::Move> moves;
+  Megaminx::MegaminxState expected;
+  for (int i=0;i<100;++i) {
+    Megaminx::Move m = rand() % Megaminx::num_moves;
+    moves.push_back(m);
+    expected.turn(m);
+  }
+  Megaminx::Algorithm a(moves);
+  Megaminx::MegaminxState s;
+  a.apply(s);
+  EXPECT_EQ(s, expected);
+
+  // Same result when written out and parsed again
+  Megaminx::MegaminxState t;
+  Megaminx::Algorithm(a.str()).apply(t);
+  EXPECT_EQ(t, expected);
+}
+
+TEST(AlgorithmTest,inverse)
+{
+  Megaminx::Algorithm a("o> x< o< x<2 b< x>3 b> x>2");
+  Megaminx::MegaminxState s;
+  a.apply(s);
+  EXPECT_FALSE(s.is_solved());
+  a.inverse().apply(s);
+  EXPECT_TRUE(s.is_solved());
+  EXPECT_EQ(a.inverse().str(), "x<2 b< x<3 b> x>2 o> x> o<");
+  (a + a.inverse()).apply(s);
+  EXPECT_TRUE(s.is_solved());
+}
+
+TEST(AlgorithmTest,apply_to_megaminx)
+{
+  Megaminx::Megaminx m;
+  m.face('x')->rotate_corner_clockwise(4);
+  m.face('x')->rotate_corner_anticlockwise(3);
+  Megaminx::Algorithm a(
+    "o> x< o< x<2 b< x>3 b> x>2 o> x<2 o< x>2 "
+    "b< x> b> x>2 o> x<3 o< x<2 b< x>2 b> x<2 "
+    "g> x< g< x<2 o< x>3 o> x> g> x< g< x> "
+    "o< x> o> x>2 g> x<3 g< x< o< x> o> x<");
+  a.apply(m);
+  EXPECT_EQ(m.str(), Megaminx::solved);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest( &argc, argv );
+  return RUN_ALL_TESTS();
+}
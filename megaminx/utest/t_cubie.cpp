@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+#include "cubie.h"
+#include "state.h"
+#include "megaminx.h"
+#include "face.h"
+#include "exceptions.h"
+#include <set>
+#include <stdlib.h>
+
+TEST(CubieStateTest,Constructor)
+{
+  Megaminx::CubieState c;
+  EXPECT_TRUE(c.is_solved());
+  EXPECT_EQ(c.twist_coordinate(), 0);
+  EXPECT_EQ(c.flip_coordinate(), 0);
+  EXPECT_EQ(c.facets().str(), Megaminx::solved);
+  EXPECT_EQ(Megaminx::CubieState(Megaminx::MegaminxState()), c);
+}
+
+TEST(CubieStateTest,geometry)
+{
+  // Every facet belongs to exactly one slot
+  std::set<int> facets;
+  for (int k=0;k<20;++k) {
+    for (int i=0;i<3;++i) {
+      int f = Megaminx::CubieState::corner_facet(k,i);
+      EXPECT_EQ(f % 2, 0);
+      facets.insert(f);
+    }
+  }
+  for (int k=0;k<30;++k) {
+    for (int i=0;i<2;++i) {
+      int f = Megaminx::CubieState::edge_facet(k,i);
+      EXPECT_EQ(f % 2, 1);
+      facets.insert(f);
+    }
+  }
+  EXPECT_EQ(facets.size(), 120);
+  // The white corner between red and green
+  EXPECT_EQ(Megaminx::CubieState::corner_facet(0,0), 0);
+  EXPECT_EQ(Megaminx::CubieState::corner_facet(0,1) / 10, 5);
+  EXPECT_EQ(Megaminx::CubieState::corner_facet(0,2) / 10, 1);
+}
+
+TEST(CubieStateTest,moves_match_facets)
+{
+  srand(42);
+  Megaminx::MegaminxState state;
+  Megaminx::CubieState cubies;
+  for (int i=0;i<500;++i) {
+    Megaminx::Move m = rand() % Megaminx::num_moves;
+    state.turn(m);
+    cubies.turn(m);
+    ASSERT_EQ(cubies.facets(), state);
+    ASSERT_EQ(Megaminx::CubieState(state), cubies);
+  }
+  EXPECT_FALSE(cubies.is_solved());
+}
+
+TEST(CubieStateTest,inverse)
+{
+  Megaminx::CubieState c;
+  for (Megaminx::Move m=0;m<Megaminx::num_moves;++m) {
+    c.turn(m);
+    EXPECT_FALSE(c.is_solved());
+    c.turn(Megaminx::inverse_move(m));
+    EXPECT_TRUE(c.is_solved());
+  }
+}
+
+TEST(CubieStateTest,twisted_corner)
+{
+  Megaminx::Megaminx m;
+  m.face('w')->rotate_corner_clockwise(0);
+  Megaminx::CubieState c(m.state());
+  EXPECT_EQ(c.corner(0), 0);
+  EXPECT_NE(c.corner_orientation(0), 0);
+  EXPECT_NE(c.twist_coordinate(), 0);
+  EXPECT_EQ(c.flip_coordinate(), 0);
+  EXPECT_EQ(c.facets(), m.state());
+  m.face('w')->rotate_corner_clockwise(0);
+  m.face('w')->rotate_corner_clockwise(0);
+  EXPECT_TRUE(Megaminx::CubieState(m.state()).is_solved());
+}
+
+TEST(CubieStateTest,invalid)
+{
+  Megaminx::MegaminxState s;
+  s.set_facet(0,0,'r');
+  EXPECT_THROW(Megaminx::CubieState c(s), Megaminx::invalid_state);
+  s = Megaminx::MegaminxState();
+  s.set_facet(0,1,'x');
+  EXPECT_THROW(Megaminx::CubieState c(s), Megaminx::invalid_state);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest( &argc, argv );
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,61 @@
+#include <gtest/gtest.h>
+#include "facet_mask.h"
+#include "state.h"
+#include "moves.h"
+#include "algorithm.h"
+
+TEST(FacetMaskTest,masks)
+{
+  // Every facet belongs to exactly one piece
+  Megaminx::FacetMask all;
+  size_t total = 0;
+  for (int slot=0;slot<20;++slot) {
+    EXPECT_EQ(Megaminx::corner_mask(slot).count(), 3u);
+    all |= Megaminx::corner_mask(slot);
+    total += 3;
+  }
+  for (int slot=0;slot<30;++slot) {
+    EXPECT_EQ(Megaminx::edge_mask(slot).count(), 2u);
+    all |= Megaminx::edge_mask(slot);
+    total += 2;
+  }
+  EXPECT_EQ(total, 120u);
+  EXPECT_TRUE(all.all());
+
+  for (int f=0;f<12;++f) {
+    EXPECT_EQ(Megaminx::face_mask(f).count(), 10u);
+    EXPECT_EQ(Megaminx::face_corners(f).size(), 5u);
+    EXPECT_EQ(Megaminx::face_edges(f).size(), 5u);
+    // The face and three facets on each side for each corner and edge
+    Megaminx::FacetMask pieces = Megaminx::face_pieces_mask(f);
+    EXPECT_EQ(pieces.count(), 25u);
+    EXPECT_EQ((pieces & Megaminx::face_mask(f)), Megaminx::face_mask(f));
+  }
+}
+
+TEST(FacetMaskTest,matches)
+{
+  Megaminx::MegaminxState solved;
+  Megaminx::MegaminxState state;
+  int w = Megaminx::face_index('w');
+  int x = Megaminx::face_index('x');
+  state.turn(Megaminx::make_move(x, true));
+
+  // Turning a face only disturbs the pieces on it, and only their
+  // facets round the sides as the face itself is one colour
+  EXPECT_FALSE(state.matches(solved, Megaminx::FacetMask().set()));
+  EXPECT_TRUE(state.matches(solved, Megaminx::face_pieces_mask(w)));
+  EXPECT_FALSE(state.matches(solved, Megaminx::face_pieces_mask(x)));
+  EXPECT_TRUE(state.matches(solved, Megaminx::FacetMask()));
+  EXPECT_EQ(state.mismatches(solved, Megaminx::FacetMask().set()), 15);
+  EXPECT_EQ(state.mismatches(solved, Megaminx::face_pieces_mask(w)), 0);
+  EXPECT_EQ(state.mismatches(solved, Megaminx::face_pieces_mask(x)), 15);
+
+  // The face itself is still one colour
+  EXPECT_TRUE(state.matches(solved, Megaminx::face_mask(x)));
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest( &argc, argv );
+  return RUN_ALL_TESTS();
+}
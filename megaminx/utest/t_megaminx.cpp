@@ -3,6 +3,8 @@
 #include "megaminx.h"
 #include "exceptions.h"
 #include <memory>
+#include <thread>
+#include <vector>
 
 TEST(MegaminxTest,Constructor)
 {
@@ -109,6 +111,30 @@ TEST(MegaminxTest,apply)
 }
 
 
+TEST(MegaminxTest,faces_from_threads)
+{
+  const Megaminx::Megaminx m;
+  Megaminx::Face* seen[4][12];
+  std::vector<std::thread> threads;
+  for (int t=0;t<4;++t) {
+    threads.emplace_back([&m, &seen, t]() {
+      for (int i=0;i<12;++i) {
+        seen[t][i] = m.face(i).get();
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  // Every thread gets the same faces
+  for (int t=1;t<4;++t) {
+    for (int i=0;i<12;++i) {
+      EXPECT_EQ(seen[t][i], seen[0][i]);
+    }
+  }
+  EXPECT_EQ(m.face(6)->opposite_face().get(), m.face(0).get());
+}
+
 //----- Death Tests
 TEST(MegaminxDeathTest,faces)
 {
@@ -0,0 +1,110 @@
+#include <gtest/gtest.h>
+#include "move_sequence.h"
+#include "state.h"
+#include "face.h"
+#include "megaminx.h"
+#include <set>
+#include <string>
+
+namespace {
+  // Add every canonical sequence of a length, tracking where they go
+  void walk(Megaminx::MegaminxState& state, Megaminx::SequenceState s, int depth,
+    std::set<std::string>& reached, size_t& sequences)
+  {
+    if (depth == 0) {
+      reached.insert(state.str());
+      ++sequences;
+      return;
+    }
+    const Megaminx::SequenceSuccessors& successors = Megaminx::sequence_successors(s);
+    for (int i=0;i<successors.count;++i) {
+      state.turn(successors.moves[i]);
+      walk(state, successors.next[i], depth - 1, reached, sequences);
+      state.undo_move(successors.moves[i]);
+    }
+  }
+}
+
+TEST(MoveSequenceTest,opposite_face)
+{
+  Megaminx::Megaminx megaminx;
+  for (int f=0;f<12;++f) {
+    int opposite = Megaminx::opposite_face(f);
+    EXPECT_NE(opposite, f);
+    EXPECT_EQ(Megaminx::opposite_face(opposite), f);
+    char colour = megaminx.face(Megaminx::colours[f])->opposite_face()->colour();
+    EXPECT_EQ(Megaminx::colours[opposite], colour);
+  }
+}
+
+TEST(MoveSequenceTest,rules)
+{
+  using Megaminx::make_move;
+  Megaminx::Move w_cw = make_move(0, true);
+  Megaminx::Move w_acw = make_move(0, false);
+  int x = Megaminx::opposite_face(0);
+  EXPECT_EQ(Megaminx::colours[x], 'x');
+  EXPECT_TRUE(Megaminx::is_canonical({}));
+  EXPECT_TRUE(Megaminx::is_canonical({w_cw}));
+  EXPECT_TRUE(Megaminx::is_canonical({w_cw, w_cw}));
+  EXPECT_FALSE(Megaminx::is_canonical({w_cw, w_acw}));
+  EXPECT_FALSE(Megaminx::is_canonical({w_cw, w_cw, w_cw}));
+  EXPECT_FALSE(Megaminx::is_canonical({w_cw, w_cw, w_acw}));
+  EXPECT_TRUE(Megaminx::is_canonical({w_cw, make_move(x, true)}));
+  EXPECT_FALSE(Megaminx::is_canonical({make_move(x, true), w_cw}));
+  EXPECT_FALSE(Megaminx::is_canonical({w_cw, make_move(x, true), w_cw}));
+  EXPECT_TRUE(Megaminx::is_canonical({w_cw, make_move(1, true), w_cw, w_cw}));
+  // Faces two apart commute too
+  int k = Megaminx::face_index('k');
+  EXPECT_FALSE(Megaminx::faces_adjacent(0, k));
+  EXPECT_TRUE(Megaminx::is_canonical({w_cw, make_move(k, false)}));
+  EXPECT_FALSE(Megaminx::is_canonical({make_move(k, false), w_cw}));
+
+  EXPECT_EQ(Megaminx::sequence_successors(Megaminx::sequence_start).count, 24);
+  for (Megaminx::SequenceState s=0;s<Megaminx::num_sequence_states;++s) {
+    const Megaminx::SequenceSuccessors& successors = Megaminx::sequence_successors(s);
+    for (int i=0;i<successors.count;++i) {
+      EXPECT_EQ(Megaminx::next_sequence_state(s, successors.moves[i]), successors.next[i]);
+    }
+  }
+}
+
+TEST(MoveSequenceTest,complete)
+{
+  // Canonical sequences still reach every state, with no duplicates
+  // at all within two moves
+  std::vector<std::set<std::string>> levels(1);
+  levels[0].insert(Megaminx::MegaminxState().str());
+  std::set<std::string> seen(levels[0]);
+  for (int depth=1;depth<=3;++depth) {
+    std::set<std::string> next;
+    for (const std::string& str : levels.back()) {
+      for (Megaminx::Move m=0;m<Megaminx::num_moves;++m) {
+        Megaminx::MegaminxState state;
+        state.parse(str);
+        state.turn(m);
+        if (seen.insert(state.str()).second) {
+          next.insert(state.str());
+        }
+      }
+    }
+    levels.push_back(next);
+
+    Megaminx::MegaminxState state;
+    std::set<std::string> reached;
+    size_t sequences = 0;
+    walk(state, Megaminx::sequence_start, depth, reached, sequences);
+    for (const std::string& str : next) {
+      EXPECT_EQ(reached.count(str), 1u);
+    }
+    if (depth <= 2) {
+      EXPECT_EQ(sequences, next.size());
+    }
+    EXPECT_LT(sequences, (size_t)(depth == 3 ? 24*24*24 : 24*24));
+  }
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest( &argc, argv );
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,69 @@
+#include <gtest/gtest.h>
+#include "move_stack.h"
+#include "state.h"
+#include "algorithm.h"
+
+namespace {
+  // Visit every node to a depth, checking each against a copied state
+  int walk(Megaminx::MoveStack& stack, const Megaminx::MegaminxState& expected, int depth)
+  {
+    EXPECT_EQ(stack.state(), expected);
+    if (depth == 0) {
+      return 1;
+    }
+    int nodes = 1;
+    for (Megaminx::Move m=0;m<Megaminx::num_moves;++m) {
+      Megaminx::MegaminxState child(expected);
+      child.turn(m);
+      stack.push(m);
+      nodes += walk(stack, child, depth - 1);
+      EXPECT_EQ(stack.pop(), m);
+    }
+    return nodes;
+  }
+}
+
+TEST(MoveStackTest,constructor)
+{
+  Megaminx::MegaminxState state;
+  Megaminx::MoveStack stack(state);
+  EXPECT_TRUE(stack.empty());
+  EXPECT_EQ(stack.depth(), 0u);
+  EXPECT_EQ(&stack.state(), &state);
+  EXPECT_EQ(stack.str(), "");
+}
+
+TEST(MoveStackTest,push_pop)
+{
+  Megaminx::MegaminxState state;
+  Megaminx::MoveStack stack(state);
+  stack.push(Megaminx::make_move(0, true));
+  stack.push(Megaminx::make_move(5, false));
+  stack.push(Megaminx::make_move(5, false));
+  EXPECT_EQ(stack.depth(), 3u);
+  EXPECT_EQ(stack.top(), Megaminx::make_move(5, false));
+  EXPECT_EQ(stack.str(), "w> B<2");
+  Megaminx::MegaminxState expected;
+  stack.algorithm().apply(expected);
+  EXPECT_EQ(state, expected);
+  EXPECT_EQ(stack.pop(), Megaminx::make_move(5, false));
+  EXPECT_EQ(stack.depth(), 2u);
+  stack.unwind();
+  EXPECT_TRUE(stack.empty());
+  EXPECT_TRUE(state.is_solved());
+}
+
+TEST(MoveStackTest,depth_first)
+{
+  Megaminx::MegaminxState state;
+  Megaminx::MoveStack stack(state);
+  int nodes = walk(stack, Megaminx::MegaminxState(), 3);
+  EXPECT_EQ(nodes, 1 + 24 + 24*24 + 24*24*24);
+  EXPECT_TRUE(stack.empty());
+  EXPECT_TRUE(state.is_solved());
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest( &argc, argv );
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,106 @@
+#include <gtest/gtest.h>
+#include "moves.h"
+#include "state.h"
+#include "face.h"
+#include "megaminx.h"
+#include "exceptions.h"
+#include "utest/face_graph.h"
+#include <memory>
+#include <array>
+#include <set>
+
+TEST(MovesTest,encoding)
+{
+  for (int f=0;f<12;++f) {
+    Megaminx::Move cw = Megaminx::make_move(f,true);
+    Megaminx::Move acw = Megaminx::make_move(f,false);
+    EXPECT_EQ(Megaminx::move_face(cw), f);
+    EXPECT_EQ(Megaminx::move_face(acw), f);
+    EXPECT_TRUE(Megaminx::move_clockwise(cw));
+    EXPECT_FALSE(Megaminx::move_clockwise(acw));
+    EXPECT_EQ(Megaminx::inverse_move(cw), acw);
+    EXPECT_EQ(Megaminx::inverse_move(acw), cw);
+  }
+  EXPECT_EQ(Megaminx::move_str(Megaminx::make_move(6,true)), "x>");
+  EXPECT_EQ(Megaminx::move_str(Megaminx::make_move(4,false)), "Y<");
+  EXPECT_EQ(Megaminx::face_index('w'), 0);
+  EXPECT_EQ(Megaminx::face_index('b'), 11);
+  EXPECT_EQ(Megaminx::face_index('j'), -1);
+  for (Megaminx::Move m=0;m<Megaminx::num_moves;++m) {
+    EXPECT_EQ(Megaminx::parse_move(Megaminx::move_str(m)), m);
+  }
+  EXPECT_THROW(Megaminx::parse_move("j>"), Megaminx::invalid_instruction);
+  EXPECT_THROW(Megaminx::parse_move("x"), Megaminx::invalid_instruction);
+  EXPECT_THROW(Megaminx::parse_move("x>2"), Megaminx::invalid_instruction);
+  EXPECT_THROW(Megaminx::parse_move("x-"), Megaminx::invalid_instruction);
+}
+
+TEST(MovesTest,permutations)
+{
+  // Every table must be a permutation
+  for (Megaminx::Move m=0;m<Megaminx::num_moves;++m) {
+    const unsigned char* from = Megaminx::move_permutation(m);
+    std::set<int> seen(from, from+120);
+    EXPECT_EQ(seen.size(), 120);
+    // 10 facets of the face plus 15 around it move
+    int moved = 0;
+    for (int i=0;i<120;++i) {
+      if (from[i] != i) ++moved;
+    }
+    EXPECT_EQ(moved, 25);
+  }
+}
+
+TEST(MovesTest,matches_face_rotation)
+{
+  auto faces = make_faces();
+  for (Megaminx::Move m=0;m<Megaminx::num_moves;++m) {
+    Megaminx::MegaminxState state;
+    label(state, faces);
+    state.turn(m);
+    auto f = faces[Megaminx::move_face(m)];
+    if (Megaminx::move_clockwise(m)) {
+      f->rotate_clockwise();
+    } else {
+      f->rotate_anticlockwise();
+    }
+    for (int i=0;i<12;++i) {
+      for (int j=0;j<10;++j) {
+        ASSERT_EQ(state.facet(i,j), faces[i]->facet(j)) << "move " << m;
+      }
+    }
+  }
+}
+
+TEST(MovesTest,inverse)
+{
+  Megaminx::MegaminxState state;
+  for (Megaminx::Move m=0;m<Megaminx::num_moves;++m) {
+    state.turn(m);
+    EXPECT_FALSE(state.is_solved());
+    state.turn(Megaminx::inverse_move(m));
+    EXPECT_TRUE(state.is_solved());
+    // Five turns is a full rotation
+    for (int i=0;i<5;++i) {
+      state.turn(m);
+    }
+    EXPECT_TRUE(state.is_solved());
+  }
+}
+
+TEST(MovesTest,connecting_edge)
+{
+  for (int f=0;f<12;++f) {
+    for (int e=0;e<5;++e) {
+      int other = Megaminx::face_index(Megaminx::connections[f][e]);
+      EXPECT_EQ(Megaminx::connecting_edge(f,other), e);
+    }
+    EXPECT_EQ(Megaminx::connecting_edge(f,f), -1);
+    EXPECT_EQ(Megaminx::connecting_edge(f,Megaminx::opposite_face(f)), -1);
+  }
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest( &argc, argv );
+  return RUN_ALL_TESTS();
+}
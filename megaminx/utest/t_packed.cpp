@@ -0,0 +1,83 @@
+#include <gtest/gtest.h>
+#include "packed.h"
+#include "state.h"
+#include "megaminx.h"
+#include "exceptions.h"
+#include <set>
+#include <unordered_set>
+#include <stdlib.h>
+
+TEST(PackedStateTest,Constructor)
+{
+  Megaminx::PackedState p;
+  EXPECT_EQ(p, Megaminx::MegaminxState().pack());
+  EXPECT_TRUE(p.unpack().is_solved());
+  // White is colour 0 so its facets pack as 0x11
+  EXPECT_EQ(p.bytes()[0], 0x11);
+  // Black is colour 11 so its facets pack as 0xcc
+  EXPECT_EQ(p.bytes()[59], 0xcc);
+}
+
+TEST(PackedStateTest,round_trip)
+{
+  srand(7);
+  Megaminx::MegaminxState s;
+  for (int i=0;i<200;++i) {
+    s.turn(rand() % Megaminx::num_moves);
+    Megaminx::PackedState p = s.pack();
+    EXPECT_EQ(p.unpack(), s);
+    Megaminx::MegaminxState t;
+    t.unpack(p);
+    EXPECT_EQ(t, s);
+    EXPECT_EQ(Megaminx::PackedState::from_bytes(p.bytes()), p);
+    EXPECT_EQ(Megaminx::PackedState::from_key(p.key()), p);
+  }
+}
+
+TEST(PackedStateTest,key)
+{
+  Megaminx::MegaminxState s;
+  s.turn(Megaminx::make_move(3,true));
+  std::string key = s.pack().key();
+  EXPECT_EQ(key.size(), 60);
+  EXPECT_EQ(key.find('\0'), std::string::npos);
+  EXPECT_THROW(Megaminx::PackedState::from_key("abc"), Megaminx::invalid_state);
+  EXPECT_THROW(Megaminx::PackedState::from_key(std::string(60,'\0')), Megaminx::invalid_state);
+}
+
+TEST(PackedStateTest,comparison)
+{
+  Megaminx::MegaminxState s1;
+  Megaminx::MegaminxState s2;
+  s2.turn(0);
+  Megaminx::PackedState p1 = s1.pack();
+  Megaminx::PackedState p2 = s2.pack();
+  EXPECT_NE(p1, p2);
+  EXPECT_TRUE(p1 < p2 || p2 < p1);
+  EXPECT_FALSE(p1 < p1);
+  EXPECT_NE(p1.hash(), p2.hash());
+
+  // Distinct states stay distinct in ordered and hashed sets
+  std::set<Megaminx::PackedState> ordered;
+  std::unordered_set<Megaminx::PackedState> hashed;
+  for (Megaminx::Move m=0;m<Megaminx::num_moves;++m) {
+    Megaminx::MegaminxState s;
+    s.turn(m);
+    ordered.insert(s.pack());
+    hashed.insert(s.pack());
+  }
+  EXPECT_EQ(ordered.size(), 24);
+  EXPECT_EQ(hashed.size(), 24);
+}
+
+TEST(PackedStateTest,invalid_colour)
+{
+  Megaminx::MegaminxState s;
+  s.set_facet(2,2,'?');
+  EXPECT_THROW(s.pack(), Megaminx::invalid_state);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest( &argc, argv );
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,123 @@
+#include <gtest/gtest.h>
+#include "state.h"
+#include "face.h"
+#include "megaminx.h"
+#include "exceptions.h"
+#include <type_traits>
+#include <stdlib.h>
+
+TEST(MegaminxStateTest,Constructor)
+{
+  Megaminx::MegaminxState s;
+  EXPECT_EQ(s.str(), Megaminx::solved);
+  EXPECT_TRUE(s.is_solved());
+  for (int i=0;i<12;++i) {
+    for (int j=0;j<10;++j) {
+      EXPECT_EQ(s.facet(i,j), Megaminx::colours[i]);
+    }
+  }
+}
+
+TEST(MegaminxStateTest,trivially_copyable)
+{
+  EXPECT_TRUE(std::is_trivially_copyable<Megaminx::MegaminxState>::value);
+  EXPECT_EQ(sizeof(Megaminx::MegaminxState), 120);
+}
+
+TEST(MegaminxStateTest,facets)
+{
+  Megaminx::MegaminxState s;
+  s.set_facet(1,3,'x');
+  EXPECT_EQ(s.facet(1,3),'x');
+  EXPECT_EQ(s.face_facets(1)[3],'x');
+  EXPECT_EQ(s.data()[13],'x');
+  EXPECT_FALSE(s.is_solved());
+  EXPECT_EQ(s.str(), "[w]rrrxrrrrrr[G][p][Y][B][x][y][k][g][o][b]");
+}
+
+TEST(MegaminxStateTest,copy)
+{
+  Megaminx::MegaminxState s1;
+  s1.set_facet(0,0,'r');
+  Megaminx::MegaminxState s2 = s1;
+  EXPECT_EQ(s1, s2);
+  s2.set_facet(0,0,'w');
+  EXPECT_NE(s1, s2);
+  EXPECT_TRUE(s2.is_solved());
+}
+
+TEST(MegaminxStateTest,parse)
+{
+  Megaminx::MegaminxState s;
+  std::string test = "[w]rrBBBrrrrrrrrGGGGGGGppppppGGGpYYYYpppYYYYBBBBBBBYY[x][y][k][g][o][b]";
+  s.parse(test);
+  EXPECT_EQ(s.str(), test);
+  EXPECT_THROW(s.parse("[w]rrBBBrrrrrrrrGGGGGGGpp"),Megaminx::parse_error);
+  EXPECT_THROW(s.parse("[w][r]"),Megaminx::parse_error);
+  // Failed parse leaves the state alone
+  EXPECT_EQ(s.str(), test);
+}
+
+TEST(MegaminxStateTest,megaminx_view)
+{
+  Megaminx::MegaminxState s;
+  s.set_facet(6,4,'b');
+  Megaminx::Megaminx m(s);
+  EXPECT_EQ(m.str(), s.str());
+  EXPECT_EQ(m.face('x')->facet(4), 'b');
+
+  // Changes through faces are seen in the state
+  m.face('w')->rotate_clockwise();
+  EXPECT_EQ(m.state().str(), m.str());
+  EXPECT_EQ(m.face('r')->facet(2), 'B');
+
+  // Changes to the state are seen through faces
+  m.state().set_facet(6,4,'x');
+  EXPECT_EQ(m.face('x')->str(), "[x]");
+}
+
+TEST(MegaminxStateTest,megaminx_copy)
+{
+  Megaminx::Megaminx m1;
+  m1.face('w')->rotate_clockwise();
+  Megaminx::Megaminx m2 = m1;
+  EXPECT_EQ(m2.str(), m1.str());
+  m2.face('w')->rotate_anticlockwise();
+  EXPECT_EQ(m2.str(), Megaminx::solved);
+  EXPECT_NE(m1.str(), Megaminx::solved);
+}
+
+TEST(MegaminxStateTest,face_outlives_megaminx)
+{
+  std::shared_ptr<Megaminx::Face> f;
+  {
+    Megaminx::Megaminx m;
+    m.face('x')->set_facet(0,'w');
+    f = m.face('x');
+  }
+  EXPECT_EQ(f->str(), "wxxxxxxxxx");
+  EXPECT_EQ(f->connected_face(0), nullptr);
+}
+
+TEST(MegaminxStateTest,undo_move)
+{
+  srand(10);
+  Megaminx::MegaminxState state;
+  Megaminx::Move moves[50];
+  for (int i=0;i<50;++i) {
+    moves[i] = rand() % Megaminx::num_moves;
+    state.turn(moves[i]);
+  }
+  for (int i=49;i>=0;--i) {
+    Megaminx::MegaminxState expected(state);
+    expected.turn(Megaminx::inverse_move(moves[i]));
+    state.undo_move(moves[i]);
+    EXPECT_EQ(state, expected);
+  }
+  EXPECT_TRUE(state.is_solved());
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest( &argc, argv );
+  return RUN_ALL_TESTS();
+}
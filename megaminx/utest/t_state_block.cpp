@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+#include "state_block.h"
+#include "state.h"
+#include "algorithm.h"
+#include "megaminx.h"
+#include <vector>
+#include <stdlib.h>
+
+// Make some different states to work with
+static std::vector<Megaminx::MegaminxState> random_states(int count)
+{
+  std::vector<Megaminx::MegaminxState> states;
+  Megaminx::MegaminxState s;
+  for (int i=0;i<count;++i) {
+    s.turn(rand() % Megaminx::num_moves);
+    states.push_back(s);
+  }
+  return states;
+}
+
+TEST(StateBlockTest,Constructor)
+{
+  Megaminx::StateBlock b;
+  EXPECT_EQ(b.size(), 0);
+  EXPECT_TRUE(b.empty());
+  b.turn(0);
+  EXPECT_TRUE(b.turned(0).empty());
+}
+
+TEST(StateBlockTest,push_back)
+{
+  srand(11);
+  auto states = random_states(300);
+  Megaminx::StateBlock b;
+  for (size_t i=0;i<states.size();++i) {
+    b.push_back(states[i]);
+    EXPECT_EQ(b.size(), i+1);
+  }
+  for (size_t i=0;i<states.size();++i) {
+    EXPECT_EQ(b.state(i), states[i]);
+  }
+  EXPECT_EQ(b.row(5)[17], states[17].data()[5]);
+  b.set_state(3, Megaminx::MegaminxState());
+  EXPECT_TRUE(b.state(3).is_solved());
+  b.clear();
+  EXPECT_TRUE(b.empty());
+}
+
+TEST(StateBlockTest,turn)
+{
+  srand(12);
+  auto states = random_states(100);
+  Megaminx::StateBlock b(states.size());
+  for (auto& s : states) {
+    b.push_back(s);
+  }
+  for (int i=0;i<50;++i) {
+    Megaminx::Move m = rand() % Megaminx::num_moves;
+    b.turn(m);
+    for (auto& s : states) {
+      s.turn(m);
+    }
+  }
+  for (size_t i=0;i<states.size();++i) {
+    EXPECT_EQ(b.state(i), states[i]);
+  }
+}
+
+TEST(StateBlockTest,apply)
+{
+  srand(13);
+  auto states = random_states(70);
+  Megaminx::StateBlock b;
+  for (auto& s : states) {
+    b.push_back(s);
+  }
+  Megaminx::Algorithm a("o> x< o< x<2 b< x>3 b> x>2 G< w>");
+  b.apply(a);
+  for (size_t i=0;i<states.size();++i) {
+    a.apply(states[i]);
+    EXPECT_EQ(b.state(i), states[i]);
+  }
+}
+
+TEST(StateBlockTest,turned)
+{
+  srand(14);
+  auto states = random_states(65);
+  Megaminx::StateBlock b;
+  for (auto& s : states) {
+    b.push_back(s);
+  }
+  for (Megaminx::Move m=0;m<Megaminx::num_moves;++m) {
+    Megaminx::StateBlock children = b.turned(m);
+    ASSERT_EQ(children.size(), b.size());
+    for (size_t i=0;i<states.size();++i) {
+      Megaminx::MegaminxState expected = states[i];
+      expected.turn(m);
+      EXPECT_EQ(children.state(i), expected);
+      // The original is left alone
+      EXPECT_EQ(b.state(i), states[i]);
+    }
+  }
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest( &argc, argv );
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+#include "symmetry.h"
+#include "state.h"
+#include "utest/scramble.h"
+#include <set>
+#include <stdlib.h>
+
+TEST(SymmetryTest,identity)
+{
+  srand(9);
+  Megaminx::MegaminxState state = scramble(30);
+  EXPECT_EQ(Megaminx::apply_symmetry(state, 0), state);
+  EXPECT_EQ(Megaminx::inverse_symmetry(0), 0);
+  for (int face=0;face<12;++face) {
+    EXPECT_EQ(Megaminx::symmetry_face(0, face), face);
+  }
+}
+
+TEST(SymmetryTest,solved)
+{
+  // The solved state looks the same from every side
+  Megaminx::MegaminxState solved;
+  for (int s=0;s<Megaminx::num_symmetries;++s) {
+    EXPECT_TRUE(Megaminx::apply_symmetry(solved, s).is_solved());
+  }
+}
+
+TEST(SymmetryTest,distinct)
+{
+  srand(10);
+  Megaminx::MegaminxState state = scramble(40);
+  std::set<std::string> states;
+  for (int s=0;s<Megaminx::num_symmetries;++s) {
+    states.insert(Megaminx::apply_symmetry(state, s).str());
+  }
+  EXPECT_EQ(states.size(), (size_t)Megaminx::num_symmetries);
+}
+
+TEST(SymmetryTest,moves)
+{
+  // Turning then applying a symmetry is the same as applying the
+  // symmetry then doing the equivalent move
+  srand(11);
+  Megaminx::MegaminxState state = scramble(20);
+  for (int s=0;s<Megaminx::num_symmetries;++s) {
+    for (Megaminx::Move m=0;m<Megaminx::num_moves;++m) {
+      Megaminx::MegaminxState turned(state);
+      turned.turn(m);
+      Megaminx::MegaminxState expected = Megaminx::apply_symmetry(state, s);
+      expected.turn(Megaminx::symmetry_move(s, m));
+      ASSERT_EQ(Megaminx::apply_symmetry(turned, s), expected) << "s=" << s << " m=" << m;
+    }
+    bool clockwise = Megaminx::move_clockwise(Megaminx::symmetry_move(s, 0));
+    EXPECT_EQ(clockwise, s < Megaminx::num_rotations);
+  }
+}
+
+TEST(SymmetryTest,inverse)
+{
+  srand(12);
+  Megaminx::MegaminxState state = scramble(30);
+  for (int s=0;s<Megaminx::num_symmetries;++s) {
+    int t = Megaminx::inverse_symmetry(s);
+    EXPECT_EQ(t >= Megaminx::num_rotations, s >= Megaminx::num_rotations);
+    EXPECT_EQ(Megaminx::apply_symmetry(Megaminx::apply_symmetry(state, s), t), state);
+  }
+}
+
+TEST(SymmetryTest,canonical)
+{
+  srand(13);
+  for (int n=0;n<20;++n) {
+    Megaminx::MegaminxState state = scramble(25);
+    int which = -1;
+    Megaminx::MegaminxState canonical = Megaminx::canonical_state(state, false, &which);
+    ASSERT_GE(which, 0);
+    ASSERT_LT(which, Megaminx::num_rotations);
+    EXPECT_EQ(Megaminx::apply_symmetry(state, which), canonical);
+    EXPECT_LE(canonical.str(), state.str());
+    Megaminx::MegaminxState mirrored = Megaminx::canonical_state(state, true);
+    for (int s=0;s<Megaminx::num_symmetries;++s) {
+      Megaminx::MegaminxState other = Megaminx::apply_symmetry(state, s);
+      if (s < Megaminx::num_rotations) {
+        ASSERT_EQ(Megaminx::canonical_state(other), canonical);
+      }
+      ASSERT_EQ(Megaminx::canonical_state(other, true), mirrored);
+    }
+  }
+  Megaminx::MegaminxState solved;
+  EXPECT_TRUE(Megaminx::canonical_state(solved).is_solved());
+}
+
+TEST(SymmetryTest,orbit)
+{
+  // A single turn of any face is the same as a turn of face 0 either
+  // way round once rotations are taken out, and the same as a clockwise
+  // turn of face 0 once reflections are too
+  std::set<std::string> rotated;
+  std::set<std::string> reflected;
+  for (Megaminx::Move m=0;m<Megaminx::num_moves;++m) {
+    Megaminx::MegaminxState state;
+    state.turn(m);
+    rotated.insert(Megaminx::canonical_state(state).str());
+    reflected.insert(Megaminx::canonical_state(state, true).str());
+  }
+  EXPECT_EQ(rotated.size(), 2u);
+  EXPECT_EQ(reflected.size(), 1u);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest( &argc, argv );
+  return RUN_ALL_TESTS();
+}
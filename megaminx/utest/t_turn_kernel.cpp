@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+#include "turn_kernel.h"
+#include "moves.h"
+#include "state.h"
+#include "face.h"
+#include "megaminx.h"
+#include "utest/face_graph.h"
+#include <memory>
+#include <array>
+#include <vector>
+#include <stdlib.h>
+
+static const Megaminx::TurnKernel all_kernels[] = {
+  Megaminx::TurnKernel::scalar,
+  Megaminx::TurnKernel::sse41,
+  Megaminx::TurnKernel::avx2,
+  Megaminx::TurnKernel::avx512vbmi
+};
+
+TEST(TurnKernelTest,supported)
+{
+  EXPECT_TRUE(Megaminx::turn_kernel_supported(Megaminx::TurnKernel::scalar));
+  EXPECT_TRUE(Megaminx::turn_kernel_supported(Megaminx::best_turn_kernel()));
+  for (auto kernel : all_kernels) {
+    RecordProperty(Megaminx::turn_kernel_name(kernel),
+      Megaminx::turn_kernel_supported(kernel) ? "yes" : "no");
+  }
+  RecordProperty("best", Megaminx::turn_kernel_name(Megaminx::best_turn_kernel()));
+}
+
+TEST(TurnKernelTest,matches_face_rotation)
+{
+  auto faces = make_faces();
+  for (auto kernel : all_kernels) {
+    if (!Megaminx::turn_kernel_supported(kernel)) {
+      continue;
+    }
+    for (Megaminx::Move m=0;m<Megaminx::num_moves;++m) {
+      Megaminx::MegaminxState state;
+      label(state, faces);
+      Megaminx::turn_facets(state.data(), m, kernel);
+      auto f = faces[Megaminx::move_face(m)];
+      if (Megaminx::move_clockwise(m)) {
+        f->rotate_clockwise();
+      } else {
+        f->rotate_anticlockwise();
+      }
+      for (int i=0;i<12;++i) {
+        for (int j=0;j<10;++j) {
+          ASSERT_EQ(state.facet(i,j), faces[i]->facet(j)) <<
+            Megaminx::turn_kernel_name(kernel) << " move " << m;
+        }
+      }
+    }
+  }
+}
+
+TEST(TurnKernelTest,random_sequences)
+{
+  srand(1234);
+  std::vector<Megaminx::Move> moves;
+  for (int i=0;i<2000;++i) {
+    moves.push_back(rand() % Megaminx::num_moves);
+  }
+  Megaminx::MegaminxState reference;
+  for (auto m : moves) {
+    Megaminx::turn_facets(reference.data(), m, Megaminx::TurnKernel::scalar);
+  }
+  for (auto kernel : all_kernels) {
+    if (!Megaminx::turn_kernel_supported(kernel)) {
+      continue;
+    }
+    Megaminx::MegaminxState state;
+    for (auto m : moves) {
+      Megaminx::turn_facets(state.data(), m, kernel);
+    }
+    EXPECT_EQ(state, reference) << Megaminx::turn_kernel_name(kernel);
+  }
+}
+
+TEST(TurnKernelTest,stays_in_bounds)
+{
+  // Kernels must not touch memory either side of the state
+  for (auto kernel : all_kernels) {
+    if (!Megaminx::turn_kernel_supported(kernel)) {
+      continue;
+    }
+    std::array<char,160> buffer;
+    buffer.fill('#');
+    Megaminx::MegaminxState state;
+    std::copy(state.data(), state.data()+120, buffer.begin()+20);
+    for (Megaminx::Move m=0;m<Megaminx::num_moves;++m) {
+      Megaminx::turn_facets(buffer.data()+20, m, kernel);
+    }
+    for (int i=0;i<20;++i) {
+      EXPECT_EQ(buffer[i], '#');
+      EXPECT_EQ(buffer[140+i], '#');
+    }
+  }
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest( &argc, argv );
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,85 @@
+#include <gtest/gtest.h>
+#include "zobrist.h"
+#include "state.h"
+#include "megaminx.h"
+#include <unordered_set>
+#include <stdlib.h>
+
+TEST(ZobristTest,Constructor)
+{
+  Megaminx::HashedState<> h;
+  EXPECT_TRUE(h.state().is_solved());
+  EXPECT_TRUE(h.verify());
+  EXPECT_EQ(h.hash(), Megaminx::zobrist_hash<1>(Megaminx::MegaminxState()));
+  // Hashes are the same from run to run
+  Megaminx::HashedState<> h2;
+  EXPECT_EQ(h.hash(), h2.hash());
+}
+
+TEST(ZobristTest,delta)
+{
+  for (Megaminx::Move m=0;m<Megaminx::num_moves;++m) {
+    EXPECT_EQ(Megaminx::zobrist_delta(m).count, 25);
+  }
+}
+
+TEST(ZobristTest,incremental)
+{
+  srand(21);
+  Megaminx::HashedState<> h;
+  Megaminx::HashedState<2> h128;
+  for (int i=0;i<1000;++i) {
+    Megaminx::Move m = rand() % Megaminx::num_moves;
+    h.turn(m);
+    h128.turn(m);
+    ASSERT_TRUE(h.verify());
+    ASSERT_TRUE(h128.verify());
+    ASSERT_EQ(h.hash().words[0], h128.hash().words[0]);
+  }
+  EXPECT_EQ(h.state(), h128.state());
+}
+
+TEST(ZobristTest,undo)
+{
+  Megaminx::HashedState<> h;
+  auto solved = h.hash();
+  for (Megaminx::Move m=0;m<Megaminx::num_moves;++m) {
+    h.turn(m);
+    EXPECT_NE(h.hash(), solved);
+    h.turn(Megaminx::inverse_move(m));
+    EXPECT_EQ(h.hash(), solved);
+  }
+}
+
+TEST(ZobristTest,distinct)
+{
+  // All states two moves from solved hash differently unless equal
+  std::unordered_set<std::string> states;
+  std::unordered_set<Megaminx::Zobrist64> hashes;
+  for (Megaminx::Move m1=0;m1<Megaminx::num_moves;++m1) {
+    for (Megaminx::Move m2=0;m2<Megaminx::num_moves;++m2) {
+      Megaminx::HashedState<> h;
+      h.turn(m1);
+      h.turn(m2);
+      states.insert(h.state().str());
+      hashes.insert(h.hash());
+    }
+  }
+  EXPECT_EQ(hashes.size(), states.size());
+}
+
+TEST(ZobristTest,non_colour_facets)
+{
+  Megaminx::MegaminxState s;
+  s.set_facet(0,0,'?');
+  Megaminx::HashedState<> h(s);
+  EXPECT_TRUE(h.verify());
+  EXPECT_NE(h.hash(), Megaminx::HashedState<>().hash());
+  h.turn(3);
+  EXPECT_TRUE(h.verify());
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest( &argc, argv );
+  return RUN_ALL_TESTS();
+}
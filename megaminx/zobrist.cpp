@@ -0,0 +1,79 @@
+#include "zobrist.h"
+#include "megaminx.h"
+#include <assert.h>
+#include <vector>
+
+namespace Megaminx {
+
+  namespace {
+    const int num_facets = MegaminxState::num_facets;
+    const int max_words = 2;
+
+    // Fixed seed so hashes are the same from run to run
+    const uint64_t zobrist_seed = 0x6d6567616d696e78ULL;
+
+    uint64_t splitmix64(uint64_t& x)
+    {
+      uint64_t z = (x += 0x9e3779b97f4a7c15ULL);
+      z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+      z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+      return z ^ (z >> 31);
+    }
+
+    struct ZobristTables {
+      uint64_t keys[max_words][num_facets * 16];
+      unsigned char nibbles[256];
+      ZobristDelta deltas[num_moves];
+    };
+
+    ZobristTables build_tables()
+    {
+      ZobristTables tables;
+      uint64_t x = zobrist_seed;
+      for (int w=0;w<max_words;++w) {
+        for (int i=0;i<num_facets * 16;++i) {
+          tables.keys[w][i] = splitmix64(x);
+        }
+      }
+      for (int c=0;c<256;++c) {
+        tables.nibbles[c] = (unsigned char)(face_index((char)c) + 1);
+      }
+      for (Move m=0;m<num_moves;++m) {
+        const unsigned char* from = move_permutation(m);
+        ZobristDelta& delta = tables.deltas[m];
+        delta.count = 0;
+        for (int i=0;i<num_facets;++i) {
+          if (from[i] != i) {
+            delta.position[delta.count] = (unsigned char)i;
+            delta.from[delta.count] = from[i];
+            ++delta.count;
+          }
+        }
+      }
+      return tables;
+    }
+
+    const ZobristTables& tables()
+    {
+      static const ZobristTables t = build_tables();
+      return t;
+    }
+  }
+
+  const uint64_t* zobrist_keys(int word)
+  {
+    assert(word >= 0 && word < max_words);
+    return tables().keys[word];
+  }
+
+  const unsigned char* zobrist_nibbles()
+  {
+    return tables().nibbles;
+  }
+
+  const ZobristDelta& zobrist_delta(Move m)
+  {
+    assert(m >= 0 && m < num_moves);
+    return tables().deltas[m];
+  }
+}
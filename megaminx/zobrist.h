@@ -0,0 +1,97 @@
+#pragma once
+#include "zobrist_def.h"
+#include <assert.h>
+
+namespace Megaminx {
+
+  template<int Words>
+  bool ZobristHash<Words>::operator==(const ZobristHash& other) const
+  {
+    return words == other.words;
+  }
+
+  template<int Words>
+  bool ZobristHash<Words>::operator!=(const ZobristHash& other) const
+  {
+    return words != other.words;
+  }
+
+  template<int Words>
+  bool ZobristHash<Words>::operator<(const ZobristHash& other) const
+  {
+    return words < other.words;
+  }
+
+  // Compute the hash from scratch
+  template<int Words>
+  ZobristHash<Words> zobrist_hash(const MegaminxState& state)
+  {
+    static_assert(Words >= 1 && Words <= 2, "Zobrist hashes are 64 or 128 bits");
+    ZobristHash<Words> result;
+    const unsigned char* nibbles = zobrist_nibbles();
+    const char* facets = state.data();
+    for (int w=0;w<Words;++w) {
+      const uint64_t* keys = zobrist_keys(w);
+      uint64_t h = 0;
+      for (int i=0;i<MegaminxState::num_facets;++i) {
+        h ^= keys[i * 16 + nibbles[(unsigned char)facets[i]]];
+      }
+      result.words[w] = h;
+    }
+    return result;
+  }
+
+  template<int Words>
+  HashedState<Words>::HashedState()
+    : m_hash(zobrist_hash<Words>(m_state))
+  {
+  }
+
+  template<int Words>
+  HashedState<Words>::HashedState(const MegaminxState& state)
+    : m_state(state),
+      m_hash(zobrist_hash<Words>(state))
+  {
+  }
+
+  template<int Words>
+  const MegaminxState& HashedState<Words>::state() const
+  {
+    return m_state;
+  }
+
+  template<int Words>
+  const typename HashedState<Words>::Hash& HashedState<Words>::hash() const
+  {
+    return m_hash;
+  }
+
+  // Apply a move, updating the hash from the facets that change
+  template<int Words>
+  void HashedState<Words>::turn(Move m)
+  {
+    assert(m >= 0 && m < num_moves);
+    const ZobristDelta& delta = zobrist_delta(m);
+    const unsigned char* nibbles = zobrist_nibbles();
+    const char* facets = m_state.data();
+    for (int w=0;w<Words;++w) {
+      const uint64_t* keys = zobrist_keys(w);
+      uint64_t h = m_hash.words[w];
+      for (int i=0;i<delta.count;++i) {
+        const uint64_t* facet_keys = keys + delta.position[i] * 16;
+        h ^= facet_keys[nibbles[(unsigned char)facets[delta.position[i]]]] ^
+          facet_keys[nibbles[(unsigned char)facets[delta.from[i]]]];
+      }
+      m_hash.words[w] = h;
+    }
+    m_state.turn(m);
+  }
+
+  // Check against a full recompute
+  template<int Words>
+  bool HashedState<Words>::verify() const
+  {
+    return m_hash == zobrist_hash<Words>(m_state);
+  }
+
+}
@@ -0,0 +1,100 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <cstddef>
+#include "moves.h"
+#include "state.h"
+
+namespace Megaminx {
+
+  /**
+   * A Zobrist hash made of one or more 64 bit words
+   * ZobristHash<1> is a plain 64 bit hash, ZobristHash<2> is 128 bits
+   */
+  template<int Words>
+  struct ZobristHash {
+    std::array<uint64_t,Words> words;
+
+    bool operator==(const ZobristHash& other) const;
+    bool operator!=(const ZobristHash& other) const;
+    bool operator<(const ZobristHash& other) const;
+  };
+
+  typedef ZobristHash<1> Zobrist64;
+  typedef ZobristHash<2> Zobrist128;
+
+  /**
+   * The facets changed by a move
+   * Facet position[i] takes the colour that was at facet from[i]
+   */
+  struct ZobristDelta {
+    int count;
+    unsigned char position[MegaminxState::num_facets];
+    unsigned char from[MegaminxState::num_facets];
+  };
+
+  /**
+   * Return the random keys for one word of the hash
+   * The key for facet f holding colour nibble n is at [f * 16 + n]
+   * @param word The word of the hash 0 -> 1
+   */
+  const uint64_t* zobrist_keys(int word);
+
+  // Return the lookup from a facet colour to its colour index plus one
+  // Anything that is not a colour gives zero
+  const unsigned char* zobrist_nibbles();
+
+  // Return the precomputed facet changes for a move
+  const ZobristDelta& zobrist_delta(Move m);
+
+  // Compute the hash of a state from scratch
+  template<int Words>
+  ZobristHash<Words> zobrist_hash(const MegaminxState& state);
+
+  /**
+   * A state with its Zobrist hash kept up to date
+   *
+   * Each move updates the hash from only the facets it changes using the
+   * precomputed per-move delta tables, instead of rehashing the state.
+   */
+  template<int Words = 1>
+  class HashedState {
+    public:
+      typedef ZobristHash<Words> Hash;
+
+      // Constructor
+      // Initialise to the solved state
+      HashedState();
+
+      // Construct from a state, computing its hash
+      explicit HashedState(const MegaminxState& state);
+
+      // The state
+      const MegaminxState& state() const;
+
+      // The hash of the state
+      const Hash& hash() const;
+
+      // Apply a move, updating the hash incrementally
+      void turn(Move m);
+
+      // Return if the incrementally maintained hash matches a full recompute
+      bool verify() const;
+
+    protected:
+    private:
+      MegaminxState m_state;
+      Hash m_hash;
+  };
+
+}
+
+namespace std {
+  template<int Words>
+  struct hash<Megaminx::ZobristHash<Words>> {
+    size_t operator()(const Megaminx::ZobristHash<Words>& h) const
+    {
+      return (size_t)h.words[0];
+    }
+  };
+}
@@ -0,0 +1,239 @@
+#include "batch.h"
+#include "solver_exceptions.h"
+#include "frontier.h"
+#include "packed.h"
+#include "DBCache.h"
+#include "ThreadPool.h"
+#include <istream>
+#include <ostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <deque>
+#include <map>
+#include <future>
+#include <chrono>
+#include <assert.h>
+
+namespace Solver {
+
+  namespace {
+    // Number of cache sets grouped into one transaction
+    const size_t cache_batch = 256;
+
+    typedef std::chrono::steady_clock Clock;
+
+    double milliseconds_since(Clock::time_point start)
+    {
+      return std::chrono::duration<double,std::milli>(Clock::now() - start).count();
+    }
+
+    // What happened to one scramble
+    struct Outcome {
+      bool ok;
+      Megaminx::Algorithm solution;
+      std::string error;
+      double milliseconds;
+    };
+
+    // A scramble waiting for its result to be written
+    struct Item {
+      size_t line;
+      std::string key;
+      std::shared_future<Outcome> outcome;
+      // Answered without solving, from the cache or an earlier line
+      bool cached;
+      // Solved by this item so its key is in the in flight map
+      bool owner;
+      double milliseconds;
+    };
+
+    std::shared_future<Outcome> ready(const Outcome& outcome)
+    {
+      std::promise<Outcome> promise;
+      promise.set_value(outcome);
+      return promise.get_future().share();
+    }
+
+    // Remove leading and trailing white space
+    std::string trim(const std::string& line)
+    {
+      size_t begin = line.find_first_not_of(" \t\r\n");
+      if (begin == std::string::npos) {
+        return std::string();
+      }
+      size_t end = line.find_last_not_of(" \t\r\n");
+      return line.substr(begin, end - begin + 1);
+    }
+  }
+
+  // Constructor
+  BatchSolver::BatchSolver(const SolveFunction& solve, Utils::DBCache* cache,
+    unsigned int threads, size_t max_in_flight)
+    : m_solve(solve),
+      m_cache(cache),
+      m_threads(thread_count(threads)),
+      m_max_in_flight(max_in_flight > 0 ? max_in_flight : 4 * m_threads),
+      m_solved(0),
+      m_cached(0),
+      m_failed(0)
+  {
+  }
+
+  // Solve a stream of scrambles
+  size_t BatchSolver::run(std::istream& in, std::ostream& out)
+  {
+    m_solved = 0;
+    m_cached = 0;
+    m_failed = 0;
+    size_t count = 0;
+    size_t uncommitted = 0;
+    std::deque<Item> pending;
+    std::map<std::string,std::shared_future<Outcome>> in_flight;
+    Utils::DBTransaction transaction(m_cache);
+
+    // Write the oldest result, waiting for it if need be
+    auto write_front = [&]() {
+      Item& item = pending.front();
+      const Outcome& outcome = item.outcome.get();
+      double milliseconds = item.cached ? item.milliseconds : outcome.milliseconds;
+      out << item.line << '\t';
+      if (!outcome.ok) {
+        out << "failed\t" << std::fixed << std::setprecision(3) << milliseconds
+          << '\t' << outcome.error;
+        ++m_failed;
+      } else {
+        out << (item.cached ? "cached\t" : "solved\t") << std::fixed << std::setprecision(3)
+          << milliseconds << '\t' << outcome.solution.str();
+        if (item.cached) {
+          ++m_cached;
+        } else {
+          ++m_solved;
+        }
+      }
+      out << '\n';
+      if (item.owner) {
+        if (outcome.ok && m_cache) {
+          m_cache->set(item.key, outcome.solution.str());
+          if (++uncommitted == cache_batch) {
+            transaction.checkpoint();
+            uncommitted = 0;
+          }
+        }
+        in_flight.erase(item.key);
+      }
+      pending.pop_front();
+    };
+
+    Utils::ThreadPool pool(m_threads);
+    std::string line;
+    size_t line_number = 0;
+    while (std::getline(in, line)) {
+      ++line_number;
+      line = trim(line);
+      if (line.empty() || line[0] == '#') {
+        continue;
+      }
+      ++count;
+      Clock::time_point start = Clock::now();
+      Item item = {line_number, std::string(), std::shared_future<Outcome>(), true, false, 0};
+      Megaminx::MegaminxState state;
+      try {
+        state = parse_scramble(line);
+      } catch (const std::exception& e) {
+        item.outcome = ready({false, Megaminx::Algorithm(), e.what(), 0});
+      }
+      if (!item.outcome.valid()) {
+        item.key = Megaminx::PackedState(state).key();
+        auto found = in_flight.find(item.key);
+        std::string value;
+        if (state.is_solved()) {
+          item.outcome = ready({true, Megaminx::Algorithm(), std::string(), 0});
+          item.cached = false;
+        } else if (found != in_flight.end()) {
+          item.outcome = found->second;
+        } else if (m_cache && !(value = m_cache->get(item.key)).empty()) {
+          item.outcome = ready({true, Megaminx::Algorithm(value), std::string(), 0});
+        } else {
+          // Solve it on the pool
+          const SolveFunction& solve = m_solve;
+          item.outcome = pool.submit([solve, state]() {
+            Clock::time_point start = Clock::now();
+            Outcome outcome = {true, Megaminx::Algorithm(), std::string(), 0};
+            try {
+              outcome.solution = solve(state);
+            } catch (const std::exception& e) {
+              outcome.ok = false;
+              outcome.error = e.what();
+            }
+            outcome.milliseconds = milliseconds_since(start);
+            return outcome;
+          }).share();
+          item.cached = false;
+          item.owner = true;
+          in_flight[item.key] = item.outcome;
+        }
+      }
+      item.milliseconds = milliseconds_since(start);
+      pending.push_back(item);
+
+      // Write whatever is done, and wait if too far ahead
+      while (!pending.empty() && (pending.size() >= m_max_in_flight ||
+        pending.front().outcome.wait_for(std::chrono::seconds(0)) == std::future_status::ready)) {
+        write_front();
+      }
+    }
+    while (!pending.empty()) {
+      write_front();
+    }
+    transaction.commit();
+    out.flush();
+    return count;
+  }
+
+  // Solve a file of scrambles
+  size_t BatchSolver::run(const std::string& input_file, const std::string& output_file)
+  {
+    std::ifstream in(input_file.c_str());
+    if (!in) {
+      throw batch_error("Error opening scramble file: " + input_file);
+    }
+    std::ofstream out(output_file.c_str());
+    if (!out) {
+      throw batch_error("Error opening output file: " + output_file);
+    }
+    return run(in, out);
+  }
+
+  // Read either format
+  Megaminx::MegaminxState BatchSolver::parse_scramble(const std::string& line)
+  {
+    Megaminx::MegaminxState state;
+    if (line.find_first_of("<>") != std::string::npos) {
+      Megaminx::Algorithm(line).apply(state);
+    } else {
+      state.parse(line);
+    }
+    return state;
+  }
+
+  size_t BatchSolver::solved() const
+  {
+    return m_solved;
+  }
+
+  size_t BatchSolver::cached() const
+  {
+    return m_cached;
+  }
+
+  size_t BatchSolver::failed() const
+  {
+    return m_failed;
+  }
+
+  unsigned int BatchSolver::threads() const
+  {
+    return m_threads;
+  }
+}
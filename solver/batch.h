@@ -0,0 +1,98 @@
+#pragma once
+
+#include <string>
+#include <iosfwd>
+#include <functional>
+#include <cstddef>
+#include "state.h"
+#include "algorithm.h"
+
+// Predeclarations
+namespace Utils {
+  class DBCache;
+}
+
+namespace Solver {
+
+  /**
+   * Solve a stream of scrambles on a pool of threads
+   *
+   * Each input line is either a state in Megaminx::str() format or a
+   * scramble in Megaminx::apply() notation applied to the solved state.
+   * Blank lines and lines starting with # are skipped. Each scramble is
+   * solved on a Utils::ThreadPool and the results are written in input
+   * order, one tab separated line each:
+   *
+   *   <input line number> <status> <milliseconds> <solution or error>
+   *
+   * where the status is solved, cached or failed. No more than
+   * max_in_flight scrambles are read ahead of the output, so memory use
+   * does not grow with the size of the input.
+   *
+   * Solutions are kept in an optional Utils::DBCache keyed by the packed
+   * state, and a scramble already in the cache, or already being solved
+   * earlier in the same batch, is answered without solving it again.
+   * The cache is only used from the calling thread.
+   */
+  class BatchSolver {
+    public:
+      // Solve one state, throwing if it cannot
+      // Called from several threads at once
+      typedef std::function<Megaminx::Algorithm(const Megaminx::MegaminxState&)> SolveFunction;
+
+      /**
+       * Constructor
+       * @param solve The function to solve each scramble with
+       * @param cache Cache of solutions. May be null
+       * @param threads Number of worker threads. 0 uses one per core
+       * @param max_in_flight Most scrambles read but not yet written.
+       *                      0 uses four per thread
+       */
+      BatchSolver(const SolveFunction& solve, Utils::DBCache* cache = nullptr,
+        unsigned int threads = 0, size_t max_in_flight = 0);
+
+      /**
+       * Solve every scramble in a stream
+       * @param in The scrambles, one per line
+       * @param out Where to write the results
+       * @return Number of scrambles read
+       */
+      size_t run(std::istream& in, std::ostream& out);
+
+      /**
+       * Solve every scramble in a file
+       * Throws a Solver::batch_error if either file cannot be opened
+       * @param input_file The scrambles, one per line
+       * @param output_file Where to write the results
+       * @return Number of scrambles read
+       */
+      size_t run(const std::string& input_file, const std::string& output_file);
+
+      // Counts of each outcome from the last run
+      size_t solved() const;
+      size_t cached() const;
+      size_t failed() const;
+
+      // Number of worker threads used
+      unsigned int threads() const;
+
+      /**
+       * Read a scramble in either input format
+       * Throws a Megaminx::parse_error or Megaminx::invalid_instruction
+       * if the line is neither
+       * @param line The scramble
+       */
+      static Megaminx::MegaminxState parse_scramble(const std::string& line);
+
+    protected:
+    private:
+      SolveFunction m_solve;
+      Utils::DBCache* m_cache;
+      unsigned int m_threads;
+      size_t m_max_in_flight;
+      size_t m_solved;
+      size_t m_cached;
+      size_t m_failed;
+  };
+
+}
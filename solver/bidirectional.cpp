@@ -0,0 +1,233 @@
+#include "bidirectional.h"
+#include "solver_exceptions.h"
+#include "frontier.h"
+#include "packed.h"
+#include "moves.h"
+#include "DBCache.h"
+#include "FilePagedQueue.h"
+#include "ThreadPool.h"
+#include <memory>
+#include <climits>
+#include <algorithm>
+#include <assert.h>
+
+namespace Solver {
+
+  namespace {
+    // Number of states expanded together
+    const size_t batch_size = 4096;
+
+    // Prefix of the frontier page files for each side
+    const char* page_prefixes[2] = {"bidir_forward", "bidir_backward"};
+
+    // Tag for the states reached by each side
+    const char side_tags[2] = {'f', 'b'};
+
+    // Move recorded for the state at each end
+    const char* end_move = "..";
+
+    // Visited map values are the side tag, the move and the depth
+    // eg. "fx>3"
+    std::string visited_value(int side, const std::string& move, int depth)
+    {
+      return side_tags[side] + move + std::to_string(depth);
+    }
+
+    int visited_depth(const std::string& value)
+    {
+      return std::stoi(value.substr(3));
+    }
+
+    // One end of the search
+    struct Side {
+      std::unique_ptr<Utils::FilePagedQueue<Megaminx::MegaminxState>> frontier;
+      size_t remaining;
+      int depth;
+    };
+
+    // Where the two searches meet
+    struct Meet {
+      int length;
+      int side;
+      Megaminx::MegaminxState state;
+      Megaminx::Move move;
+    };
+  }
+
+  // Constructor
+  BidirectionalSearch::BidirectionalSearch(const std::string& directory,
+    Utils::DBCache& visited, unsigned int threads, size_t page_size)
+    : m_directory(directory),
+      m_visited(&visited),
+      m_threads(thread_count(threads)),
+      m_page_size(page_size)
+  {
+  }
+
+  // Search from both ends
+  bool BidirectionalSearch::search(const Megaminx::MegaminxState& start,
+    const Megaminx::MegaminxState& goal, int max_depth)
+  {
+    m_solution = Megaminx::Algorithm();
+    const Megaminx::MegaminxState* ends[2] = {&start, &goal};
+    for (int s=0;s<2;++s) {
+      m_level_sizes[s].assign(1, 1);
+    }
+    if (start == goal) {
+      return true;
+    }
+
+    // States left from an earlier search would count as seen
+    m_visited->clear();
+    Meet meet;
+    meet.length = INT_MAX;
+    {
+      Side sides[2];
+      for (int s=0;s<2;++s) {
+        m_visited->set(Megaminx::PackedState(*ends[s]).key(), visited_value(s, end_move, 0));
+        sides[s].frontier.reset(new Utils::FilePagedQueue<Megaminx::MegaminxState>(
+          m_directory, page_prefixes[s], m_page_size));
+        sides[s].frontier->push(*ends[s]);
+        sides[s].remaining = 1;
+        sides[s].depth = 0;
+      }
+
+      std::vector<Megaminx::MegaminxState> parents;
+      std::vector<Expansion> children;
+      Utils::ThreadPool pool(m_threads);
+      while (meet.length == INT_MAX &&
+        sides[0].depth + sides[1].depth < max_depth &&
+        sides[0].remaining > 0 && sides[1].remaining > 0) {
+        // Grow the smaller frontier by a whole level
+        int s = sides[1].remaining < sides[0].remaining ? 1 : 0;
+        Side& side = sides[s];
+        size_t level_size = 0;
+        while (side.remaining > 0) {
+          size_t count = std::min(side.remaining, batch_size);
+          parents.resize(count);
+          for (size_t i=0;i<count;++i) {
+            parents[i] = side.frontier->front();
+            side.frontier->pop();
+          }
+          side.remaining -= count;
+
+          expand_states(parents, children, pool);
+
+          Utils::DBTransaction transaction(m_visited);
+          for (const Expansion& child : children) {
+            std::string key = child.key.key();
+            std::string value = m_visited->get(key);
+            if (value.empty()) {
+              m_visited->set(key, visited_value(s, Megaminx::move_str(child.move), side.depth + 1));
+              side.frontier->push(child.state);
+              ++level_size;
+            } else if (value[0] != side_tags[s]) {
+              // Met the other side. Keep the shortest meet of this level
+              int length = side.depth + 1 + visited_depth(value);
+              if (length < meet.length) {
+                meet.length = length;
+                meet.side = s;
+                meet.state = child.state;
+                meet.move = child.move;
+              }
+            }
+          }
+          transaction.commit();
+        }
+        ++side.depth;
+        m_level_sizes[s].push_back(level_size);
+        side.remaining = level_size;
+      }
+    }
+    for (int s=0;s<2;++s) {
+      remove_page_files(m_directory, page_prefixes[s]);
+    }
+    if (meet.length == INT_MAX || meet.length > max_depth) {
+      return false;
+    }
+
+    // The meeting state was reached by the other side. Its parent on
+    // this side is one move back
+    Megaminx::MegaminxState parent(meet.state);
+    parent.undo_move(meet.move);
+    std::vector<Megaminx::Move> forward;
+    std::vector<Megaminx::Move> backward;
+    if (meet.side == 0) {
+      forward = path_from('f', parent);
+      forward.push_back(meet.move);
+      backward = path_from('b', meet.state);
+    } else {
+      forward = path_from('f', meet.state);
+      backward = path_from('b', parent);
+      backward.push_back(meet.move);
+    }
+    // The backward half is walked from the goal so goes in reverse
+    Megaminx::Algorithm undo = Megaminx::Algorithm(backward).inverse();
+    forward.insert(forward.end(), undo.moves().begin(), undo.moves().end());
+    m_solution = Megaminx::Algorithm(forward);
+    return true;
+  }
+
+  // Find the shortest solution
+  Megaminx::Algorithm BidirectionalSearch::solve(const Megaminx::MegaminxState& start,
+    int max_depth)
+  {
+    if (!search(start, Megaminx::MegaminxState(), max_depth)) {
+      throw not_found("No solution within " + std::to_string(max_depth) + " moves");
+    }
+    return m_solution;
+  }
+
+  // Follow the moves recorded by one side back to its end
+  std::vector<Megaminx::Move> BidirectionalSearch::path_from(char side,
+    Megaminx::MegaminxState state) const
+  {
+    std::vector<Megaminx::Move> moves;
+    while (true) {
+      std::string value = m_visited->get(Megaminx::PackedState(state).key());
+      if (value.empty() || value[0] != side) {
+        throw not_found("State has not been visited: " + state.str());
+      }
+      std::string move = value.substr(1, 2);
+      if (move == end_move) {
+        break;
+      }
+      Megaminx::Move m = Megaminx::parse_move(move);
+      moves.push_back(m);
+      state.undo_move(m);
+    }
+    std::reverse(moves.begin(), moves.end());
+    return moves;
+  }
+
+  const Megaminx::Algorithm& BidirectionalSearch::solution() const
+  {
+    return m_solution;
+  }
+
+  const std::vector<size_t>& BidirectionalSearch::forward_level_sizes() const
+  {
+    return m_level_sizes[0];
+  }
+
+  const std::vector<size_t>& BidirectionalSearch::backward_level_sizes() const
+  {
+    return m_level_sizes[1];
+  }
+
+  size_t BidirectionalSearch::visited_count() const
+  {
+    size_t count = 0;
+    for (int s=0;s<2;++s) {
+      for (size_t size : m_level_sizes[s]) {
+        count += size;
+      }
+    }
+    return count;
+  }
+
+  unsigned int BidirectionalSearch::threads() const
+  {
+    return m_threads;
+  }
+}
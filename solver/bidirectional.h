@@ -0,0 +1,89 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include "state.h"
+#include "algorithm.h"
+
+// Predeclarations
+namespace Utils {
+  class DBCache;
+}
+
+namespace Solver {
+
+  /**
+   * Breadth first search from both ends at once
+   *
+   * One frontier grows out from the start and one back from the goal,
+   * each in its own Utils::FilePagedQueue. Both record the states they
+   * reach in one shared Utils::DBCache, tagged with the side that reached
+   * them, the move that did and the depth. A child already tagged by the
+   * other side is where the two searches meet. Each step expands a whole
+   * level of whichever frontier is smaller, and the shortest meet from
+   * that level gives an optimal path, so the searches only need to reach
+   * half the solution length each.
+   *
+   * The path is stitched together from the recorded moves from the
+   * start to the meeting state, followed by the moves from the goal to
+   * the meeting state inverted.
+   */
+  class BidirectionalSearch {
+    public:
+      /**
+       * Constructor
+       * @param directory Existing directory for the frontier page files
+       * @param visited The visited map. Cleared at the start of each search
+       * @param threads Number of worker threads. 0 uses one per core
+       * @param page_size Number of states held in memory per queue page
+       */
+      BidirectionalSearch(const std::string& directory, Utils::DBCache& visited,
+        unsigned int threads = 0, size_t page_size = 100000);
+
+      /**
+       * Search for the shortest path between two states
+       * @param start The state to start from
+       * @param goal The state to get to
+       * @param max_depth The longest path to look for
+       * @return If a path was found
+       */
+      bool search(const Megaminx::MegaminxState& start,
+        const Megaminx::MegaminxState& goal, int max_depth);
+
+      /**
+       * Find the shortest way to solve a state
+       * Throws a Solver::not_found if there is none within max_depth
+       * @param start The state to solve
+       * @param max_depth The furthest to search
+       */
+      Megaminx::Algorithm solve(const Megaminx::MegaminxState& start, int max_depth);
+
+      // The moves from the start to the goal found by the last search
+      const Megaminx::Algorithm& solution() const;
+
+      // Number of new states found at each depth from each end
+      // Both start with the end state itself at depth 0
+      const std::vector<size_t>& forward_level_sizes() const;
+      const std::vector<size_t>& backward_level_sizes() const;
+
+      // Total number of states visited by the last search
+      size_t visited_count() const;
+
+      // Number of worker threads used
+      unsigned int threads() const;
+
+    protected:
+    private:
+      // Rebuild the moves from one end of the search to a visited state
+      std::vector<Megaminx::Move> path_from(char side, Megaminx::MegaminxState state) const;
+
+      std::string m_directory;
+      Utils::DBCache* m_visited;
+      unsigned int m_threads;
+      size_t m_page_size;
+      Megaminx::Algorithm m_solution;
+      std::vector<size_t> m_level_sizes[2];
+  };
+
+}
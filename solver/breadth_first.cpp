@@ -0,0 +1,156 @@
+#include "breadth_first.h"
+#include "solver_exceptions.h"
+#include "packed.h"
+#include "moves.h"
+#include "DBCache.h"
+#include "FilePagedQueue.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <assert.h>
+
+namespace Solver {
+
+  namespace {
+    // Number of states expanded together
+    const size_t batch_size = 4096;
+
+    // Prefix of the frontier page files
+    const char* page_prefix = "bfs_frontier";
+
+    // Visited map value for the start state
+    const char* start_marker = ".";
+  }
+
+  // Constructor
+  BreadthFirstSearch::BreadthFirstSearch(const std::string& directory,
+    Utils::DBCache& visited, unsigned int threads, size_t page_size)
+    : m_directory(directory),
+      m_visited(&visited),
+      m_threads(thread_count(threads)),
+      m_page_size(page_size)
+  {
+  }
+
+  // Search outwards from a state
+  bool BreadthFirstSearch::search(const Megaminx::MegaminxState& start,
+    int max_depth, const Goal& goal)
+  {
+    m_solution = Megaminx::Algorithm();
+    m_level_sizes.assign(1, 1);
+    // States left from an earlier search would count as seen
+    m_visited->clear();
+    m_visited->set(Megaminx::PackedState(start).key(), start_marker);
+    if (goal && goal(start)) {
+      return true;
+    }
+
+    bool found = false;
+    Megaminx::MegaminxState found_state;
+    {
+      Utils::FilePagedQueue<Megaminx::MegaminxState> frontier(m_directory, page_prefix, m_page_size);
+      frontier.push(start);
+      size_t remaining = 1;
+      std::vector<Megaminx::MegaminxState> parents;
+      std::vector<Expansion> children;
+      Utils::ThreadPool pool(m_threads);
+      for (int depth=1;depth<=max_depth && remaining>0 && !found;++depth) {
+        size_t level_size = 0;
+        while (remaining > 0 && !found) {
+          // Take the next batch off this level
+          size_t count = std::min(remaining, batch_size);
+          parents.resize(count);
+          for (size_t i=0;i<count;++i) {
+            parents[i] = frontier.front();
+            frontier.pop();
+          }
+          remaining -= count;
+
+          // Expand it across the worker threads
+          expand_states(parents, children, pool, goal);
+
+          // Record and queue the states not seen before
+          Utils::DBTransaction transaction(m_visited);
+          for (const Expansion& child : children) {
+            std::string key = child.key.key();
+            if (!m_visited->get(key).empty()) {
+              continue;
+            }
+            m_visited->set(key, Megaminx::move_str(child.move));
+            ++level_size;
+            if (child.goal) {
+              found = true;
+              found_state = child.state;
+              break;
+            }
+            frontier.push(child.state);
+          }
+          transaction.commit();
+        }
+        m_level_sizes.push_back(level_size);
+        remaining = level_size;
+      }
+    }
+    remove_page_files(m_directory, page_prefix);
+
+    if (found) {
+      m_solution = path_to(found_state);
+    }
+    return found;
+  }
+
+  // Find the shortest solution
+  Megaminx::Algorithm BreadthFirstSearch::solve(const Megaminx::MegaminxState& start,
+    int max_depth)
+  {
+    Goal solved = [](const Megaminx::MegaminxState& state) { return state.is_solved(); };
+    if (!search(start, max_depth, solved)) {
+      throw not_found("No solution within " + std::to_string(max_depth) + " moves");
+    }
+    return m_solution;
+  }
+
+  const Megaminx::Algorithm& BreadthFirstSearch::solution() const
+  {
+    return m_solution;
+  }
+
+  const std::vector<size_t>& BreadthFirstSearch::level_sizes() const
+  {
+    return m_level_sizes;
+  }
+
+  size_t BreadthFirstSearch::visited_count() const
+  {
+    size_t count = 0;
+    for (size_t size : m_level_sizes) {
+      count += size;
+    }
+    return count;
+  }
+
+  // Follow the recorded moves back to the start
+  Megaminx::Algorithm BreadthFirstSearch::path_to(const Megaminx::MegaminxState& state) const
+  {
+    Megaminx::MegaminxState current(state);
+    std::vector<Megaminx::Move> moves;
+    while (true) {
+      std::string value = m_visited->get(Megaminx::PackedState(current).key());
+      if (value.empty()) {
+        throw not_found("State has not been visited: " + current.str());
+      }
+      if (value == start_marker) {
+        break;
+      }
+      Megaminx::Move m = Megaminx::parse_move(value);
+      moves.push_back(m);
+      current.undo_move(m);
+    }
+    std::reverse(moves.begin(), moves.end());
+    return Megaminx::Algorithm(moves);
+  }
+
+  unsigned int BreadthFirstSearch::threads() const
+  {
+    return m_threads;
+  }
+}
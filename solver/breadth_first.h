@@ -0,0 +1,92 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include "state.h"
+#include "algorithm.h"
+#include "frontier.h"
+
+// Predeclarations
+namespace Utils {
+  class DBCache;
+}
+
+namespace Solver {
+
+  /**
+   * Multi-threaded breadth first search over puzzle states
+   *
+   * The frontier is held in a Utils::FilePagedQueue so it spills to disk
+   * once it no longer fits in memory. Every state reached is recorded in a
+   * Utils::DBCache against the move that reached it, so the path to any
+   * visited state can be rebuilt by taking the moves back one at a time.
+   *
+   * Each level is expanded in batches. The worker threads turn every
+   * state of a batch by every move and test the children against the
+   * goal. The calling thread alone talks to the visited map, dropping
+   * children that have been seen before and queueing the rest.
+   */
+  class BreadthFirstSearch {
+    public:
+      /**
+       * Constructor
+       * @param directory Existing directory for the frontier page files
+       * @param visited The visited map. Cleared at the start of each search
+       * @param threads Number of worker threads. 0 uses one per core
+       * @param page_size Number of states held in memory per queue page
+       */
+      BreadthFirstSearch(const std::string& directory, Utils::DBCache& visited,
+        unsigned int threads = 0, size_t page_size = 100000);
+
+      /**
+       * Search outwards from a state
+       * Stops at the first state that passes the goal test or once every
+       * state up to max_depth moves away has been visited
+       * @param start The state to search from
+       * @param max_depth The furthest to search
+       * @param goal The goal test. If empty every state is visited
+       * @return If a goal state was found
+       */
+      bool search(const Megaminx::MegaminxState& start, int max_depth,
+        const Goal& goal = Goal());
+
+      /**
+       * Find the shortest way to solve a state
+       * Throws a Solver::not_found if there is none within max_depth
+       * @param start The state to solve
+       * @param max_depth The furthest to search
+       */
+      Megaminx::Algorithm solve(const Megaminx::MegaminxState& start, int max_depth);
+
+      // The moves from the start to the goal state found by the last search
+      const Megaminx::Algorithm& solution() const;
+
+      // Number of new states found at each depth by the last search
+      // Starting with the start state itself at depth 0
+      const std::vector<size_t>& level_sizes() const;
+
+      // Total number of states visited by the last search
+      size_t visited_count() const;
+
+      /**
+       * Rebuild the path from the start of the search to a visited state
+       * Throws a Solver::not_found if the state has not been visited
+       * @param state The visited state
+       */
+      Megaminx::Algorithm path_to(const Megaminx::MegaminxState& state) const;
+
+      // Number of worker threads used
+      unsigned int threads() const;
+
+    protected:
+    private:
+      std::string m_directory;
+      Utils::DBCache* m_visited;
+      unsigned int m_threads;
+      size_t m_page_size;
+      Megaminx::Algorithm m_solution;
+      std::vector<size_t> m_level_sizes;
+  };
+
+}
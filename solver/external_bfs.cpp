@@ -0,0 +1,301 @@
+#include "external_bfs.h"
+#include "solver_exceptions.h"
+#include "frontier.h"
+#include "ThreadPool.h"
+#include <fstream>
+#include <memory>
+#include <queue>
+#include <algorithm>
+#include <stdio.h>
+#include <assert.h>
+
+namespace Solver {
+
+  namespace {
+    // Number of states expanded together
+    const size_t batch_size = 4096;
+
+    // Prefix of all the files
+    const char* file_prefix = "ebfs_";
+
+    // Size of each state on disk
+    const size_t record_size = Megaminx::PackedState::num_bytes;
+
+    // Size of the stream buffer for each file
+    const size_t buffer_size = 1 << 20;
+
+    // Reads packed states one at a time from a file
+    class RecordReader {
+      public:
+        explicit RecordReader(const std::string& filename)
+          : m_buffer(buffer_size), m_valid(false)
+        {
+          m_in.rdbuf()->pubsetbuf(m_buffer.data(), m_buffer.size());
+          m_in.open(filename.c_str(), std::ios::binary);
+          if (!m_in) {
+            throw search_file_error("Error opening search file: " + filename);
+          }
+          next();
+        }
+
+        // Return if there is a current state
+        bool valid() const
+        {
+          return m_valid;
+        }
+
+        const Megaminx::PackedState& current() const
+        {
+          return m_current;
+        }
+
+        // Move on to the next state
+        void next()
+        {
+          unsigned char bytes[record_size];
+          m_valid = (bool)m_in.read((char*)bytes, record_size);
+          if (m_valid) {
+            m_current = Megaminx::PackedState::from_bytes(bytes);
+          }
+        }
+
+      private:
+        std::vector<char> m_buffer;
+        std::ifstream m_in;
+        Megaminx::PackedState m_current;
+        bool m_valid;
+    };
+
+    // Writes packed states to a file
+    class RecordWriter {
+      public:
+        explicit RecordWriter(const std::string& filename)
+          : m_filename(filename), m_buffer(buffer_size)
+        {
+          m_out.rdbuf()->pubsetbuf(m_buffer.data(), m_buffer.size());
+          m_out.open(filename.c_str(), std::ios::binary | std::ios::trunc);
+          if (!m_out) {
+            throw search_file_error("Error creating search file: " + filename);
+          }
+        }
+
+        void write(const Megaminx::PackedState& state)
+        {
+          m_out.write((const char*)state.bytes(), record_size);
+        }
+
+        void close()
+        {
+          m_out.close();
+          if (!m_out) {
+            throw search_file_error("Error writing search file: " + m_filename);
+          }
+        }
+
+      private:
+        std::string m_filename;
+        std::vector<char> m_buffer;
+        std::ofstream m_out;
+    };
+
+    // Sort and write one run, leaving out repeats
+    void write_run(std::vector<Megaminx::PackedState>& states, const std::string& filename)
+    {
+      std::sort(states.begin(), states.end());
+      auto end = std::unique(states.begin(), states.end());
+      RecordWriter out(filename);
+      for (auto it=states.begin();it!=end;++it) {
+        out.write(*it);
+      }
+      out.close();
+      states.clear();
+    }
+
+    // Order for the merge heap, smallest state on top
+    struct RunOrder {
+      const std::vector<std::unique_ptr<RecordReader>>* runs;
+      bool operator()(size_t a, size_t b) const
+      {
+        return (*runs)[b]->current() < (*runs)[a]->current();
+      }
+    };
+
+    // Move a reader up to a state and return if it has it
+    bool seen_in(RecordReader* level, const Megaminx::PackedState& state)
+    {
+      if (!level) {
+        return false;
+      }
+      while (level->valid() && level->current() < state) {
+        level->next();
+      }
+      return level->valid() && level->current() == state;
+    }
+  }
+
+  // Constructor
+  ExternalBreadthFirstSearch::ExternalBreadthFirstSearch(const std::string& directory,
+    unsigned int threads, size_t run_size)
+    : m_directory(directory),
+      m_threads(thread_count(threads)),
+      m_run_size(run_size),
+      m_run_count(0)
+  {
+    assert(run_size > 0);
+  }
+
+  // Visit every state up to a depth
+  size_t ExternalBreadthFirstSearch::search(const Megaminx::MegaminxState& start,
+    int max_depth, const Visitor& visitor)
+  {
+    m_level_sizes.assign(1, 1);
+    m_run_count = 0;
+    {
+      Megaminx::PackedState packed(start);
+      RecordWriter out(level_file(0));
+      out.write(packed);
+      out.close();
+      if (visitor) {
+        visitor(0, packed);
+      }
+    }
+    try {
+      Utils::ThreadPool pool(m_threads);
+      for (int depth=0;depth<max_depth && m_level_sizes.back()>0;++depth) {
+        size_t runs = write_runs(pool, depth);
+        m_run_count += runs;
+        m_level_sizes.push_back(merge_runs(depth, runs, visitor));
+        // Only the last two levels are needed to find duplicates
+        if (depth > 0) {
+          remove(level_file(depth - 1).c_str());
+        }
+      }
+    } catch (...) {
+      remove_page_files(m_directory, file_prefix);
+      throw;
+    }
+    remove_page_files(m_directory, file_prefix);
+    return visited_count();
+  }
+
+  // Expand a level into sorted runs
+  size_t ExternalBreadthFirstSearch::write_runs(Utils::ThreadPool& pool, int depth)
+  {
+    RecordReader level(level_file(depth));
+    std::vector<Megaminx::PackedState> run;
+    run.reserve(m_run_size);
+    std::vector<Megaminx::MegaminxState> parents;
+    std::vector<Expansion> children;
+    size_t runs = 0;
+    while (level.valid()) {
+      parents.clear();
+      while (level.valid() && parents.size() < batch_size) {
+        parents.push_back(level.current().unpack());
+        level.next();
+      }
+      expand_states(parents, children, pool);
+      for (const Expansion& child : children) {
+        run.push_back(child.key);
+        if (run.size() == m_run_size) {
+          write_run(run, run_file(depth + 1, runs++));
+        }
+      }
+    }
+    if (!run.empty()) {
+      write_run(run, run_file(depth + 1, runs++));
+    }
+    return runs;
+  }
+
+  // Merge the runs leaving out anything in the last two levels
+  size_t ExternalBreadthFirstSearch::merge_runs(int depth, size_t runs, const Visitor& visitor)
+  {
+    std::vector<std::unique_ptr<RecordReader>> readers;
+    for (size_t r=0;r<runs;++r) {
+      readers.emplace_back(new RecordReader(run_file(depth + 1, r)));
+    }
+    std::unique_ptr<RecordReader> current(new RecordReader(level_file(depth)));
+    std::unique_ptr<RecordReader> previous;
+    if (depth > 0) {
+      previous.reset(new RecordReader(level_file(depth - 1)));
+    }
+
+    RunOrder order = {&readers};
+    std::priority_queue<size_t,std::vector<size_t>,RunOrder> heap(order);
+    for (size_t r=0;r<runs;++r) {
+      if (readers[r]->valid()) {
+        heap.push(r);
+      }
+    }
+
+    RecordWriter out(level_file(depth + 1));
+    size_t count = 0;
+    bool have_last = false;
+    Megaminx::PackedState last;
+    while (!heap.empty()) {
+      size_t r = heap.top();
+      heap.pop();
+      Megaminx::PackedState state = readers[r]->current();
+      readers[r]->next();
+      if (readers[r]->valid()) {
+        heap.push(r);
+      }
+      // Runs are each free of repeats but can share states
+      if (have_last && state == last) {
+        continue;
+      }
+      last = state;
+      have_last = true;
+      if (seen_in(current.get(), state) || seen_in(previous.get(), state)) {
+        continue;
+      }
+      out.write(state);
+      ++count;
+      if (visitor) {
+        visitor(depth + 1, state);
+      }
+    }
+    out.close();
+
+    readers.clear();
+    for (size_t r=0;r<runs;++r) {
+      remove(run_file(depth + 1, r).c_str());
+    }
+    return count;
+  }
+
+  std::string ExternalBreadthFirstSearch::level_file(int depth) const
+  {
+    return m_directory + "/" + file_prefix + "level_" + std::to_string(depth) + ".dat";
+  }
+
+  std::string ExternalBreadthFirstSearch::run_file(int depth, size_t run) const
+  {
+    return m_directory + "/" + file_prefix + "run_" + std::to_string(depth) + "_" +
+      std::to_string(run) + ".dat";
+  }
+
+  const std::vector<size_t>& ExternalBreadthFirstSearch::level_sizes() const
+  {
+    return m_level_sizes;
+  }
+
+  size_t ExternalBreadthFirstSearch::visited_count() const
+  {
+    size_t count = 0;
+    for (size_t size : m_level_sizes) {
+      count += size;
+    }
+    return count;
+  }
+
+  size_t ExternalBreadthFirstSearch::run_count() const
+  {
+    return m_run_count;
+  }
+
+  unsigned int ExternalBreadthFirstSearch::threads() const
+  {
+    return m_threads;
+  }
+}
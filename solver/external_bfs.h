@@ -0,0 +1,88 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <functional>
+#include "state.h"
+#include "packed.h"
+
+// Predeclarations
+namespace Utils {
+  class ThreadPool;
+}
+
+namespace Solver {
+
+  /**
+   * Breadth first enumeration with delayed duplicate detection
+   *
+   * No visited map is kept. Each level is a file of packed states in
+   * sorted order. The children of a level are gathered in memory until
+   * there are run_size of them, then sorted and written out as a run, so
+   * generating a level only ever appends to files. The runs are then
+   * merged together with the two levels before, which are the only
+   * places a child can have been seen already, dropping the duplicates
+   * and writing the new level in sorted order. Every read and write is
+   * sequential, so the speed is set by disk bandwidth rather than the
+   * latency of a lookup for each state.
+   */
+  class ExternalBreadthFirstSearch {
+    public:
+      // Called with each new state as it is found
+      typedef std::function<void(int depth, const Megaminx::PackedState& state)> Visitor;
+
+      /**
+       * Constructor
+       * @param directory Existing directory for the level and run files
+       * @param threads Number of worker threads. 0 uses one per core
+       * @param run_size Number of states sorted in memory at once
+       */
+      ExternalBreadthFirstSearch(const std::string& directory, unsigned int threads = 0,
+        size_t run_size = 1 << 20);
+
+      /**
+       * Visit every state up to a depth
+       * Throws a Solver::search_file_error if a file cannot be used
+       * @param start The state to search from
+       * @param max_depth The furthest to search
+       * @param visitor Called for every state found, in sorted order
+       *                within each level. May be empty
+       * @return Total number of states visited
+       */
+      size_t search(const Megaminx::MegaminxState& start, int max_depth,
+        const Visitor& visitor = Visitor());
+
+      // Number of new states found at each depth
+      // Starts with the start state itself at depth 0
+      const std::vector<size_t>& level_sizes() const;
+
+      // Total number of states visited by the last search
+      size_t visited_count() const;
+
+      // Number of sorted runs written by the last search
+      size_t run_count() const;
+
+      // Number of worker threads used
+      unsigned int threads() const;
+
+    protected:
+    private:
+      // Expand a level into sorted runs and return how many there were
+      size_t write_runs(Utils::ThreadPool& pool, int depth);
+
+      // Merge the runs for a level into the next level file
+      size_t merge_runs(int depth, size_t runs, const Visitor& visitor);
+
+      // File names
+      std::string level_file(int depth) const;
+      std::string run_file(int depth, size_t run) const;
+
+      std::string m_directory;
+      unsigned int m_threads;
+      size_t m_run_size;
+      std::vector<size_t> m_level_sizes;
+      size_t m_run_count;
+  };
+
+}
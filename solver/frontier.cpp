@@ -0,0 +1,71 @@
+#include "frontier.h"
+#include "ThreadPool.h"
+#include <thread>
+#include <future>
+#include <algorithm>
+#include <filesystem>
+#include <assert.h>
+namespace fs = std::experimental::filesystem;
+
+namespace Solver {
+
+  namespace {
+    // Expand part of a batch
+    void expand_range(const std::vector<Megaminx::MegaminxState>& parents,
+      size_t begin, size_t end, std::vector<Expansion>& children, const Goal& goal)
+    {
+      for (size_t i=begin;i<end;++i) {
+        Expansion* child = &children[i * Megaminx::num_moves];
+        for (Megaminx::Move m=0;m<Megaminx::num_moves;++m,++child) {
+          child->state = parents[i];
+          child->state.turn(m);
+          child->key = Megaminx::PackedState(child->state);
+          child->move = m;
+          child->goal = goal && goal(child->state);
+        }
+      }
+    }
+  }
+
+  // Expand states across the pool
+  void expand_states(const std::vector<Megaminx::MegaminxState>& parents,
+    std::vector<Expansion>& children, Utils::ThreadPool& pool, const Goal& goal)
+  {
+    size_t count = parents.size();
+    children.resize(count * Megaminx::num_moves);
+    size_t share = (count + pool.size() - 1) / pool.size();
+    std::vector<std::future<void>> parts;
+    for (size_t begin=0;begin<count;begin+=share) {
+      size_t end = std::min(count, begin + share);
+      parts.push_back(pool.submit([&parents, begin, end, &children, &goal]() {
+        expand_range(parents, begin, end, children, goal);
+      }));
+    }
+    // Every part uses the vectors so wait for them all before any error
+    for (std::future<void>& part : parts) {
+      part.wait();
+    }
+    for (std::future<void>& part : parts) {
+      part.get();
+    }
+  }
+
+  unsigned int thread_count(unsigned int threads)
+  {
+    if (threads == 0) {
+      threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    return threads;
+  }
+
+  // Remove page files left behind
+  void remove_page_files(const std::string& directory, const std::string& prefix)
+  {
+    for (const fs::directory_entry& entry : fs::directory_iterator(directory)) {
+      std::string name = entry.path().filename().string();
+      if (name.compare(0, prefix.size(), prefix) == 0) {
+        fs::remove(entry.path());
+      }
+    }
+  }
+}
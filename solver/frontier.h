@@ -0,0 +1,50 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <functional>
+#include "state.h"
+#include "packed.h"
+#include "moves.h"
+
+// Predeclarations
+namespace Utils {
+  class ThreadPool;
+}
+
+namespace Solver {
+
+  // Test for the state a search is looking for
+  typedef std::function<bool(const Megaminx::MegaminxState&)> Goal;
+
+  // A state reached from the frontier of a search
+  struct Expansion {
+    Megaminx::MegaminxState state;
+    Megaminx::PackedState key;
+    Megaminx::Move move;
+    bool goal;
+  };
+
+  /**
+   * Turn every state by every move across the threads of a pool
+   * The children of parents[i] are put in children[i * num_moves + m]
+   * A search keeps one pool for all its batches
+   * @param parents The states to expand
+   * @param children Set to the expanded states
+   * @param pool The worker threads to use
+   * @param goal Goal test for the children. May be empty
+   */
+  void expand_states(const std::vector<Megaminx::MegaminxState>& parents,
+    std::vector<Expansion>& children, Utils::ThreadPool& pool, const Goal& goal = Goal());
+
+  // Return the number of threads to use, 0 meaning one per core
+  unsigned int thread_count(unsigned int threads);
+
+  /**
+   * Remove page files left behind by a queue that was not emptied
+   * @param directory The directory of the queue
+   * @param prefix The prefix of the page files
+   */
+  void remove_page_files(const std::string& directory, const std::string& prefix);
+
+}
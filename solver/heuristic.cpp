@@ -0,0 +1,23 @@
+#include "heuristic.h"
+#include "megaminx.h"
+
+namespace Solver {
+
+  // Round up so the estimate is never more than the moves needed
+  int MisplacedFacetsHeuristic::estimate(const Megaminx::MegaminxState& state) const
+  {
+    return (misplaced(state) + facets_per_move - 1) / facets_per_move;
+  }
+
+  int MisplacedFacetsHeuristic::misplaced(const Megaminx::MegaminxState& state)
+  {
+    int count = 0;
+    for (int face=0;face<Megaminx::MegaminxState::num_faces;++face) {
+      const char* facets = state.face_facets(face);
+      for (int i=0;i<Megaminx::MegaminxState::facets_per_face;++i) {
+        count += facets[i] != Megaminx::colours[face];
+      }
+    }
+    return count;
+  }
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "state.h"
+
+namespace Solver {
+
+  /**
+   * Interface for an estimate of the moves needed to solve a state
+   *
+   * To give optimal solutions the estimate must be admissible, that is it
+   * must never be more than the true number of moves.
+   */
+  class Heuristic {
+    public:
+      // Return the estimated number of moves to solve a state
+      virtual int estimate(const Megaminx::MegaminxState& state) const = 0;
+
+      // Virtual destructor
+      virtual ~Heuristic() {}
+  };
+
+  /**
+   * Counts the facets that are not the colour of their face
+   * A move moves 25 facets, but the 10 on the turned face only change
+   * places with others that should be that face's colour. So at most the
+   * 15 on the neighbouring faces can go from wrong to right
+   */
+  class MisplacedFacetsHeuristic : public Heuristic {
+    public:
+      int estimate(const Megaminx::MegaminxState& state) const override;
+
+      // Number of facets that are not the colour of their face
+      static int misplaced(const Megaminx::MegaminxState& state);
+
+      // The most facets one move can put right
+      static const int facets_per_move = 15;
+  };
+
+}
@@ -0,0 +1,117 @@
+#include "ida_star.h"
+#include "heuristic.h"
+#include "solver_exceptions.h"
+#include "move_stack.h"
+#include <limits>
+#include <assert.h>
+
+namespace Solver {
+
+  namespace {
+    const double no_bound = std::numeric_limits<double>::infinity();
+  }
+
+  // Constructor
+  IdaStar::IdaStar(const Heuristic& heuristic, double weight)
+    : m_heuristic(&heuristic),
+      m_weight(weight),
+      m_bound(0),
+      m_next_bound(no_bound),
+      m_nodes(0)
+  {
+    assert(weight >= 1.0);
+  }
+
+  // Search for a solution
+  bool IdaStar::search(const Megaminx::MegaminxState& start, int max_depth)
+  {
+    m_solution = Megaminx::Algorithm();
+    m_iterations.clear();
+    Megaminx::MegaminxState state(start);
+    Megaminx::MoveStack stack(state, max_depth);
+    m_bound = m_weight * m_heuristic->estimate(start);
+    while (m_bound != no_bound) {
+      m_next_bound = no_bound;
+      m_nodes = 0;
+      bool found = bounded_search(stack, Megaminx::sequence_start, max_depth);
+      m_iterations.push_back({m_bound, m_nodes});
+      if (found) {
+        m_solution = stack.algorithm();
+        return true;
+      }
+      m_bound = m_next_bound;
+    }
+    return false;
+  }
+
+  // Search to the current bound
+  bool IdaStar::bounded_search(Megaminx::MoveStack& stack,
+    Megaminx::SequenceState sequence, int max_depth)
+  {
+    const Megaminx::MegaminxState& state = stack.state();
+    int depth = (int)stack.depth();
+    int estimate = m_heuristic->estimate(state);
+    // Nothing below here can be solved within the maximum depth
+    if (depth + estimate > max_depth) {
+      return false;
+    }
+    double f = depth + m_weight * estimate;
+    if (f > m_bound) {
+      if (f < m_next_bound) {
+        m_next_bound = f;
+      }
+      return false;
+    }
+    // An admissible estimate is always zero for the solved state
+    if (estimate == 0 && state.is_solved()) {
+      return true;
+    }
+    if (depth == max_depth) {
+      return false;
+    }
+    ++m_nodes;
+    // Only follow canonical sequences of moves
+    const Megaminx::SequenceSuccessors& successors = Megaminx::sequence_successors(sequence);
+    for (int i=0;i<successors.count;++i) {
+      stack.push(successors.moves[i]);
+      if (bounded_search(stack, successors.next[i], max_depth)) {
+        return true;
+      }
+      stack.pop();
+    }
+    return false;
+  }
+
+  // Find a solution
+  Megaminx::Algorithm IdaStar::solve(const Megaminx::MegaminxState& start, int max_depth)
+  {
+    if (!search(start, max_depth)) {
+      throw not_found("No solution within " + std::to_string(max_depth) + " moves");
+    }
+    return m_solution;
+  }
+
+  const Megaminx::Algorithm& IdaStar::solution() const
+  {
+    return m_solution;
+  }
+
+  std::string IdaStar::str() const
+  {
+    return m_solution.str();
+  }
+
+  const std::vector<IdaStar::Iteration>& IdaStar::iterations() const
+  {
+    return m_iterations;
+  }
+
+  size_t IdaStar::nodes() const
+  {
+    size_t count = 0;
+    for (const Iteration& iteration : m_iterations) {
+      count += iteration.nodes;
+    }
+    return count;
+  }
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include "state.h"
+#include "algorithm.h"
+#include "move_sequence.h"
+
+namespace Megaminx {
+  class MoveStack;
+}
+
+namespace Solver {
+
+  // Predeclarations
+  class Heuristic;
+
+  /**
+   * Iterative deepening A* search for a solution
+   *
+   * Each iteration is a depth first search that cuts off any node whose
+   * moves so far plus the heuristic estimate is over the bound. The next
+   * bound is the smallest value that was cut off. Moves are made and
+   * taken back on one state so memory use only grows with the depth.
+   * Only canonical move sequences are searched, see
+   * Megaminx::sequence_successors(), so each node tries far fewer moves.
+   *
+   * With an admissible heuristic and a weight of 1 the solution is
+   * optimal. A weight w above 1 scales the estimate, which searches far
+   * fewer nodes and gives a solution no more than w times optimal.
+   */
+  class IdaStar {
+    public:
+      // What happened in one iteration of the search
+      struct Iteration {
+        double bound;
+        size_t nodes;
+      };
+
+      /**
+       * Constructor
+       * @param heuristic The estimate of moves to solve a state
+       * @param weight Multiplier for the estimate, at least 1
+       */
+      explicit IdaStar(const Heuristic& heuristic, double weight = 1.0);
+
+      /**
+       * Search for a solution
+       * @param start The state to solve
+       * @param max_depth The longest solution to look for
+       * @return If a solution was found
+       */
+      bool search(const Megaminx::MegaminxState& start, int max_depth);
+
+      /**
+       * Find a solution
+       * Throws a Solver::not_found if there is none within max_depth
+       * @param start The state to solve
+       * @param max_depth The longest solution to look for
+       */
+      Megaminx::Algorithm solve(const Megaminx::MegaminxState& start, int max_depth);
+
+      // The solution found by the last search
+      const Megaminx::Algorithm& solution() const;
+
+      // The solution in Megaminx::apply() notation
+      std::string str() const;
+
+      // The iterations of the last search
+      const std::vector<Iteration>& iterations() const;
+
+      // Total nodes expanded by the last search
+      size_t nodes() const;
+
+    protected:
+    private:
+      // Depth first search to the current bound
+      // Returns true if solved otherwise sets m_next_bound
+      bool bounded_search(Megaminx::MoveStack& stack, Megaminx::SequenceState sequence,
+        int max_depth);
+
+      const Heuristic* m_heuristic;
+      double m_weight;
+      double m_bound;
+      double m_next_bound;
+      size_t m_nodes;
+      Megaminx::Algorithm m_solution;
+      std::vector<Iteration> m_iterations;
+  };
+
+}
@@ -0,0 +1,124 @@
+#include "optimizer.h"
+#include "packed.h"
+#include "DBCache.h"
+#include <algorithm>
+#include <assert.h>
+
+namespace Solver {
+
+  namespace {
+    // Number of table sets grouped into one transaction
+    const size_t table_batch = 4096;
+  }
+
+  // Constructor
+  SolutionOptimizer::SolutionOptimizer(Utils::DBCache& table, int max_window)
+    : m_table(&table),
+      m_max_window(max_window),
+      m_replacements(0)
+  {
+    assert(max_window >= 2);
+  }
+
+  // Fill the table a depth at a time so the first sequence found for a
+  // state is the shortest
+  size_t SolutionOptimizer::build(int depth)
+  {
+    size_t added = 0;
+    m_lookups.clear();
+    Megaminx::MegaminxState state;
+    std::vector<Megaminx::Move> moves;
+    for (int d=1;d<=depth;++d) {
+      Utils::DBTransaction transaction(m_table);
+      build_sequences(transaction, state, Megaminx::sequence_start, moves, d, added);
+      transaction.commit();
+    }
+    return added;
+  }
+
+  // Add the sequences of one length
+  void SolutionOptimizer::build_sequences(Utils::DBTransaction& transaction,
+    Megaminx::MegaminxState& state, Megaminx::SequenceState sequence,
+    std::vector<Megaminx::Move>& moves, int depth, size_t& added)
+  {
+    if (depth == 0) {
+      if (state.is_solved()) {
+        return;
+      }
+      std::string key = Megaminx::PackedState(state).key();
+      if (m_table->get(key).empty()) {
+        m_table->set(key, Megaminx::Algorithm(moves).str());
+        if (++added % table_batch == 0) {
+          transaction.checkpoint();
+        }
+      }
+      return;
+    }
+    const Megaminx::SequenceSuccessors& successors = Megaminx::sequence_successors(sequence);
+    for (int i=0;i<successors.count;++i) {
+      state.turn(successors.moves[i]);
+      moves.push_back(successors.moves[i]);
+      build_sequences(transaction, state, successors.next[i], moves, depth - 1, added);
+      moves.pop_back();
+      state.undo_move(successors.moves[i]);
+    }
+  }
+
+  // Look up a window
+  bool SolutionOptimizer::lookup(const Megaminx::MegaminxState& effect,
+    Megaminx::Algorithm& replacement)
+  {
+    if (effect.is_solved()) {
+      replacement = Megaminx::Algorithm();
+      return true;
+    }
+    std::string key = Megaminx::PackedState(effect).key();
+    auto found = m_lookups.find(key);
+    if (found == m_lookups.end()) {
+      found = m_lookups.insert(std::make_pair(key, m_table->get(key))).first;
+    }
+    if (found->second.empty()) {
+      return false;
+    }
+    replacement = Megaminx::Algorithm(found->second);
+    return true;
+  }
+
+  // Splice in shorter windows until there are none
+  Megaminx::Algorithm SolutionOptimizer::optimize(const Megaminx::Algorithm& solution)
+  {
+    m_replacements = 0;
+    std::vector<Megaminx::Move> moves = solution.moves();
+    Megaminx::Algorithm replacement;
+    // Windows ending before a splice have been tried already
+    size_t first = 0;
+    bool improved = true;
+    while (improved) {
+      improved = false;
+      for (size_t start=first;start<moves.size() && !improved;++start) {
+        // Grow the window one move at a time from this start
+        Megaminx::MegaminxState effect;
+        size_t limit = std::min(moves.size(), start + m_max_window);
+        for (size_t end=start;end<limit && !improved;++end) {
+          effect.turn(moves[end]);
+          size_t length = end - start + 1;
+          if (length < 2 || !lookup(effect, replacement) || replacement.size() >= length) {
+            continue;
+          }
+          const std::vector<Megaminx::Move>& shorter = replacement.moves();
+          moves.erase(moves.begin() + start, moves.begin() + end + 1);
+          moves.insert(moves.begin() + start, shorter.begin(), shorter.end());
+          ++m_replacements;
+          improved = true;
+          first = start + 1 > (size_t)m_max_window ? start + 1 - m_max_window : 0;
+        }
+      }
+    }
+    return Megaminx::Algorithm(moves);
+  }
+
+  size_t SolutionOptimizer::replacements() const
+  {
+    return m_replacements;
+  }
+}
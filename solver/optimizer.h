@@ -0,0 +1,82 @@
+#pragma once
+
+#include <string>
+#include <map>
+#include <cstddef>
+#include "state.h"
+#include "algorithm.h"
+#include "move_sequence.h"
+
+// Predeclarations
+namespace Utils {
+  class DBCache;
+  class DBTransaction;
+}
+
+namespace Solver {
+
+  /**
+   * Shorten solutions by replacing short runs of moves
+   *
+   * Uses a table in a Utils::DBCache of the shortest move sequence for
+   * every state within a few moves of solved, keyed by the packed state.
+   * A window slides over the solution and the net effect of the moves in
+   * it is looked up in the table. Where the table has a shorter sequence
+   * with the same effect it is spliced in, and a window that does
+   * nothing at all is removed. This repeats until no window gets any
+   * shorter, so the optimized solution has exactly the same effect as
+   * the original and is never longer.
+   *
+   * The table should have its own cache as it uses packed state keys.
+   */
+  class SolutionOptimizer {
+    public:
+      /**
+       * Constructor
+       * @param table The cache holding the optimal sequences
+       * @param max_window The most moves to replace at once
+       */
+      explicit SolutionOptimizer(Utils::DBCache& table, int max_window = 6);
+
+      /**
+       * Fill the table with every state up to a depth
+       * States already in the table are left as they are, so a table can
+       * be extended by building it again to a greater depth
+       * @param depth The longest sequences to add
+       * @return Number of sequences added
+       */
+      size_t build(int depth);
+
+      /**
+       * Return a solution with the same effect that is as short as the
+       * table can make it
+       * @param solution The moves to shorten
+       */
+      Megaminx::Algorithm optimize(const Megaminx::Algorithm& solution);
+
+      /**
+       * Return the shortest known sequence with the same effect as a window
+       * Returns false if there is nothing in the table for it
+       * @param effect The state the window takes the solved state to
+       * @param replacement Set to the shortest sequence
+       */
+      bool lookup(const Megaminx::MegaminxState& effect, Megaminx::Algorithm& replacement);
+
+      // Number of replacements made by the last optimize
+      size_t replacements() const;
+
+    protected:
+    private:
+      // Add every canonical sequence of a length not already in the table
+      void build_sequences(Utils::DBTransaction& transaction, Megaminx::MegaminxState& state,
+        Megaminx::SequenceState sequence, std::vector<Megaminx::Move>& moves, int depth,
+        size_t& added);
+
+      Utils::DBCache* m_table;
+      int m_max_window;
+      size_t m_replacements;
+      // Lookups already made, including misses
+      std::map<std::string,std::string> m_lookups;
+  };
+
+}
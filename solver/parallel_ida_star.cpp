@@ -0,0 +1,307 @@
+#include "parallel_ida_star.h"
+#include "heuristic.h"
+#include "solver_exceptions.h"
+#include "frontier.h"
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <limits>
+#include <algorithm>
+#include <assert.h>
+
+namespace Solver {
+
+  namespace {
+    const double no_bound = std::numeric_limits<double>::infinity();
+
+    // A subtree waiting to be searched
+    struct Task {
+      std::vector<Megaminx::Move> path;
+      Megaminx::SequenceState sequence;
+    };
+
+    // One thread's subtrees
+    // The owner works at the back and thieves take from the front
+    struct WorkQueue {
+      std::mutex mutex;
+      std::deque<Task> tasks;
+    };
+
+  }
+
+  // Counts kept by one thread
+  // Each has a cache line to itself so threads do not slow each other down
+  struct alignas(64) ParallelIdaStar::ThreadCounts {
+    size_t nodes;
+    double next_bound;
+  };
+
+  // State shared by the threads during one iteration
+  struct ParallelIdaStar::Shared {
+    Shared(const Megaminx::MegaminxState& start, int max_depth,
+      double bound, unsigned int threads)
+      : start(start), max_depth(max_depth), bound(bound),
+        queues(threads), counts(threads),
+        pending(0), idle(0), steals(0), donations(0), found(false)
+    {
+    }
+
+    // Wake the threads waiting for work
+    void wake()
+    {
+      // Taking the lock means no thread can miss the change
+      {
+        std::lock_guard<std::mutex> lock(work_mutex);
+      }
+      work_ready.notify_all();
+    }
+
+    const Megaminx::MegaminxState& start;
+    int max_depth;
+    double bound;
+    std::vector<WorkQueue> queues;
+    // Each thread keeps its counts on its own stack and copies them here
+    // when it finishes. A vector does not promise the alignment
+    std::vector<ThreadCounts> counts;
+    // Subtrees queued or being searched
+    std::atomic<size_t> pending;
+    // Threads looking for work
+    std::atomic<unsigned int> idle;
+    std::atomic<size_t> steals;
+    // Number of times subtrees have been given away
+    std::atomic<size_t> donations;
+    std::mutex work_mutex;
+    std::condition_variable work_ready;
+    // Set once any thread finds a solution
+    std::atomic<bool> found;
+    std::mutex solution_mutex;
+    std::vector<Megaminx::Move> solution;
+  };
+
+  // Constructor
+  ParallelIdaStar::ParallelIdaStar(const Heuristic& heuristic, unsigned int threads,
+    double weight, int split_depth)
+    : m_heuristic(&heuristic),
+      m_threads(thread_count(threads)),
+      m_weight(weight),
+      m_split_depth(split_depth),
+      m_steals(0)
+  {
+    assert(weight >= 1.0);
+  }
+
+  // Search for a solution
+  bool ParallelIdaStar::search(const Megaminx::MegaminxState& start, int max_depth)
+  {
+    m_solution = Megaminx::Algorithm();
+    m_iterations.clear();
+    m_steals = 0;
+    double bound = m_weight * m_heuristic->estimate(start);
+    while (bound != no_bound) {
+      Shared shared(start, max_depth, bound, m_threads);
+      bool found = search_iteration(shared);
+      size_t nodes = 0;
+      double next_bound = no_bound;
+      for (unsigned int i=0;i<m_threads;++i) {
+        nodes += shared.counts[i].nodes;
+        next_bound = std::min(next_bound, shared.counts[i].next_bound);
+      }
+      m_iterations.push_back({bound, nodes});
+      m_steals += shared.steals;
+      if (found) {
+        m_solution = Megaminx::Algorithm(shared.solution);
+        return true;
+      }
+      bound = next_bound;
+    }
+    return false;
+  }
+
+  // Run the threads for one iteration
+  bool ParallelIdaStar::search_iteration(Shared& shared)
+  {
+    shared.queues[0].tasks.push_back({std::vector<Megaminx::Move>(), Megaminx::sequence_start});
+    shared.pending = 1;
+    std::vector<std::thread> workers;
+    for (unsigned int i=1;i<m_threads;++i) {
+      workers.emplace_back(&ParallelIdaStar::worker, this, std::ref(shared), i);
+    }
+    worker(shared, 0);
+    for (std::thread& worker : workers) {
+      worker.join();
+    }
+    return shared.found;
+  }
+
+  // Search subtrees until there are none left
+  void ParallelIdaStar::worker(Shared& shared, unsigned int index)
+  {
+    ThreadCounts counts = {0, no_bound};
+    bool idle = false;
+    Megaminx::MegaminxState state;
+    std::vector<Megaminx::Move> path;
+    while (!shared.found && shared.pending > 0) {
+      size_t donations = shared.donations;
+      // Newest of our own subtrees, else the oldest of someone else's
+      Task task;
+      bool have_task = false;
+      for (unsigned int k=0;k<m_threads && !have_task;++k) {
+        WorkQueue& queue = shared.queues[(index + k) % m_threads];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.tasks.empty()) {
+          if (k == 0) {
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+          } else {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+            ++shared.steals;
+          }
+          have_task = true;
+        }
+      }
+      if (!have_task) {
+        if (!idle) {
+          idle = true;
+          ++shared.idle;
+        }
+        // Sleep until there is something new to look at rather than
+        // locking every queue again
+        std::unique_lock<std::mutex> lock(shared.work_mutex);
+        shared.work_ready.wait(lock, [&shared, donations]() {
+          return shared.found || shared.pending == 0 || shared.donations != donations;
+        });
+        continue;
+      }
+      if (idle) {
+        idle = false;
+        --shared.idle;
+      }
+
+      state = shared.start;
+      for (Megaminx::Move m : task.path) {
+        state.turn(m);
+      }
+      path.swap(task.path);
+      if (bounded_search(shared, index, counts, state, path, task.sequence)) {
+        {
+          std::lock_guard<std::mutex> lock(shared.solution_mutex);
+          if (!shared.found) {
+            shared.solution = path;
+            shared.found = true;
+          }
+        }
+        shared.wake();
+      }
+      if (--shared.pending == 0) {
+        shared.wake();
+      }
+    }
+    if (idle) {
+      --shared.idle;
+    }
+    shared.counts[index] = counts;
+  }
+
+  // Search to the current bound
+  bool ParallelIdaStar::bounded_search(Shared& shared, unsigned int index, ThreadCounts& counts,
+    Megaminx::MegaminxState& state, std::vector<Megaminx::Move>& path,
+    Megaminx::SequenceState sequence)
+  {
+    if (shared.found) {
+      return false;
+    }
+    int depth = (int)path.size();
+    int estimate = m_heuristic->estimate(state);
+    if (depth + estimate > shared.max_depth) {
+      return false;
+    }
+    double f = depth + m_weight * estimate;
+    if (f > shared.bound) {
+      if (f < counts.next_bound) {
+        counts.next_bound = f;
+      }
+      return false;
+    }
+    if (estimate == 0 && state.is_solved()) {
+      return true;
+    }
+    if (depth == shared.max_depth) {
+      return false;
+    }
+    ++counts.nodes;
+    const Megaminx::SequenceSuccessors& successors = Megaminx::sequence_successors(sequence);
+    int count = successors.count;
+    if (count > 1 && depth <= m_split_depth && shared.idle > 0) {
+      // Give all but the first child to whoever is idle
+      {
+        WorkQueue& queue = shared.queues[index];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        for (int i=1;i<count;++i) {
+          Task task = {path, successors.next[i]};
+          task.path.push_back(successors.moves[i]);
+          queue.tasks.push_back(std::move(task));
+        }
+        shared.pending += count - 1;
+      }
+      ++shared.donations;
+      shared.wake();
+      count = 1;
+    }
+    for (int i=0;i<count;++i) {
+      state.turn(successors.moves[i]);
+      path.push_back(successors.moves[i]);
+      if (bounded_search(shared, index, counts, state, path, successors.next[i])) {
+        return true;
+      }
+      path.pop_back();
+      state.undo_move(successors.moves[i]);
+    }
+    return false;
+  }
+
+  // Find a solution
+  Megaminx::Algorithm ParallelIdaStar::solve(const Megaminx::MegaminxState& start, int max_depth)
+  {
+    if (!search(start, max_depth)) {
+      throw not_found("No solution within " + std::to_string(max_depth) + " moves");
+    }
+    return m_solution;
+  }
+
+  const Megaminx::Algorithm& ParallelIdaStar::solution() const
+  {
+    return m_solution;
+  }
+
+  std::string ParallelIdaStar::str() const
+  {
+    return m_solution.str();
+  }
+
+  const std::vector<ParallelIdaStar::Iteration>& ParallelIdaStar::iterations() const
+  {
+    return m_iterations;
+  }
+
+  size_t ParallelIdaStar::nodes() const
+  {
+    size_t count = 0;
+    for (const Iteration& iteration : m_iterations) {
+      count += iteration.nodes;
+    }
+    return count;
+  }
+
+  size_t ParallelIdaStar::steals() const
+  {
+    return m_steals;
+  }
+
+  unsigned int ParallelIdaStar::threads() const
+  {
+    return m_threads;
+  }
+}
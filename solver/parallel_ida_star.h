@@ -0,0 +1,110 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include "state.h"
+#include "algorithm.h"
+#include "move_sequence.h"
+#include "ida_star.h"
+
+namespace Solver {
+
+  // Predeclarations
+  class Heuristic;
+
+  /**
+   * Iterative deepening A* search across worker threads
+   *
+   * Each thread has its own deque of subtrees to search. A thread works
+   * depth first on the newest subtree in its own deque and, when that is
+   * empty, steals the oldest subtree from another thread's deque, which
+   * is the nearest the root and so likely the most work. While any
+   * thread is idle, a node no deeper than the split depth donates all but
+   * one of its children to its thread's deque instead of searching them
+   * itself, so uneven subtrees are spread out as the search goes rather
+   * than only at the root.
+   *
+   * Every thread uses the same bound for an iteration. The first thread
+   * to find a solution sets a shared flag that stops the others, and as
+   * every smaller bound has already been searched the solution is still
+   * optimal for an admissible heuristic with a weight of 1. Only
+   * canonical move sequences are searched, as with IdaStar.
+   */
+  class ParallelIdaStar {
+    public:
+      typedef IdaStar::Iteration Iteration;
+
+      /**
+       * Constructor
+       * @param heuristic The estimate of moves to solve a state. Must be
+       *                  safe to call from several threads at once
+       * @param threads Number of worker threads. 0 uses one per core
+       * @param weight Multiplier for the estimate, at least 1
+       * @param split_depth The deepest node that can donate its children
+       */
+      ParallelIdaStar(const Heuristic& heuristic, unsigned int threads = 0,
+        double weight = 1.0, int split_depth = 6);
+
+      /**
+       * Search for a solution
+       * @param start The state to solve
+       * @param max_depth The longest solution to look for
+       * @return If a solution was found
+       */
+      bool search(const Megaminx::MegaminxState& start, int max_depth);
+
+      /**
+       * Find a solution
+       * Throws a Solver::not_found if there is none within max_depth
+       * @param start The state to solve
+       * @param max_depth The longest solution to look for
+       */
+      Megaminx::Algorithm solve(const Megaminx::MegaminxState& start, int max_depth);
+
+      // The solution found by the last search
+      const Megaminx::Algorithm& solution() const;
+
+      // The solution in Megaminx::apply() notation
+      std::string str() const;
+
+      // The iterations of the last search
+      const std::vector<Iteration>& iterations() const;
+
+      // Total nodes expanded by the last search
+      size_t nodes() const;
+
+      // Number of subtrees taken from another thread by the last search
+      size_t steals() const;
+
+      // Number of worker threads used
+      unsigned int threads() const;
+
+    protected:
+    private:
+      // State shared by the threads during one iteration
+      struct Shared;
+      // Counts kept by one thread during one iteration
+      struct ThreadCounts;
+
+      // Search one iteration across all the threads
+      bool search_iteration(Shared& shared);
+
+      // Take subtrees from the deques until the iteration is done
+      void worker(Shared& shared, unsigned int index);
+
+      // Depth first search to the current bound from a node
+      bool bounded_search(Shared& shared, unsigned int index, ThreadCounts& counts,
+        Megaminx::MegaminxState& state, std::vector<Megaminx::Move>& path,
+        Megaminx::SequenceState sequence);
+
+      const Heuristic* m_heuristic;
+      unsigned int m_threads;
+      double m_weight;
+      int m_split_depth;
+      Megaminx::Algorithm m_solution;
+      std::vector<Iteration> m_iterations;
+      size_t m_steals;
+  };
+
+}
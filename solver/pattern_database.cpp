@@ -0,0 +1,480 @@
+#include "pattern_database.h"
+#include "solver_exceptions.h"
+#include "frontier.h"
+#include "cubie.h"
+#include "state.h"
+#include "megaminx.h"
+#include "MappedFile.h"
+#include <atomic>
+#include <thread>
+#include <fstream>
+#include <algorithm>
+#include <string.h>
+#include <stdio.h>
+#include <assert.h>
+
+namespace Solver {
+
+  namespace {
+    const char magic[8] = {'M','M','X','P','D','B','\0','\0'};
+    const uint32_t version = 1;
+    const size_t header_size = 256;
+    const int max_levels = 16;
+
+    // The start of a table file
+    // Written as is so the file is only readable on the same architecture
+    struct TableHeader {
+      char magic[8];
+      uint32_t version;
+      uint32_t complete;
+      uint32_t num_corners;
+      uint32_t num_edges;
+      unsigned char corners[Megaminx::CubieState::num_corners];
+      unsigned char edges[Megaminx::CubieState::num_edges];
+      uint64_t size;
+      uint64_t num_levels;
+      uint64_t level_counts[max_levels];
+    };
+    static_assert(sizeof(TableHeader) <= header_size, "Table header too big");
+
+    // Read and write 4 bit distances
+    inline int get_distance(const unsigned char* table, uint64_t rank)
+    {
+      return (table[rank >> 1] >> ((rank & 1) << 2)) & 0xF;
+    }
+
+    inline void set_distance(unsigned char* table, uint64_t rank, int distance)
+    {
+      int shift = (int)((rank & 1) << 2);
+      unsigned char& byte = table[rank >> 1];
+      byte = (unsigned char)((byte & ~(0xF << shift)) | (distance << shift));
+    }
+
+    // Split ranks between threads on whole words of the mark bitset
+    uint64_t thread_share(uint64_t size, unsigned int threads)
+    {
+      return ((size + threads - 1) / threads + 63) & ~(uint64_t)63;
+    }
+
+    // Run a function over every share of the ranks on its own thread
+    template<class F>
+    void parallel_for(uint64_t size, unsigned int threads, F f)
+    {
+      uint64_t share = thread_share(size, threads);
+      std::vector<std::thread> workers;
+      for (uint64_t begin=share;begin<size;begin+=share) {
+        workers.emplace_back(f, begin, std::min(size, begin + share));
+      }
+      f(0, std::min(size, share));
+      for (std::thread& worker : workers) {
+        worker.join();
+      }
+    }
+  }
+
+  const int PatternDatabase::unknown;
+
+  // Constructor
+  PatternDatabase::PatternDatabase(const std::vector<int>& corners, const std::vector<int>& edges)
+    : m_distances(nullptr)
+  {
+    init_group(m_groups[0], Megaminx::CubieState::num_corners, 3, corners, true);
+    init_group(m_groups[1], Megaminx::CubieState::num_edges, 2, edges, false);
+    m_size = m_groups[0].size * m_groups[1].size;
+  }
+
+  PatternDatabase::~PatternDatabase()
+  {
+  }
+
+  // Work out the size and move tables for one kind of piece
+  void PatternDatabase::init_group(PieceGroup& group, int slots, int orientations,
+    const std::vector<int>& pieces, bool corners)
+  {
+    assert((int)pieces.size() <= slots);
+    group.slots = slots;
+    group.orientations = orientations;
+    group.pieces = pieces;
+    group.size = 1;
+    for (size_t i=0;i<pieces.size();++i) {
+      assert(pieces[i] >= 0 && pieces[i] < slots);
+      assert(std::count(pieces.begin(), pieces.end(), pieces[i]) == 1);
+      group.size *= (uint64_t)(slots - i) * orientations;
+    }
+    // A move on the solved puzzle shows where it takes the piece in each
+    // slot and how much it twists it
+    for (Megaminx::Move m=0;m<Megaminx::num_moves;++m) {
+      Megaminx::CubieState state;
+      state.turn(m);
+      for (int slot=0;slot<slots;++slot) {
+        int piece = corners ? state.corner(slot) : state.edge(slot);
+        int twist = corners ? state.corner_orientation(slot) : state.edge_orientation(slot);
+        group.to[m][piece] = (unsigned char)slot;
+        group.twist[m][piece] = (unsigned char)twist;
+      }
+    }
+    for (int slot=0;slot<slots;++slot) {
+      for (int f=0;f<orientations;++f) {
+        group.facets[slot][f] = (unsigned char)(corners ?
+          Megaminx::CubieState::corner_facet(slot, f) : Megaminx::CubieState::edge_facet(slot, f));
+      }
+    }
+    for (size_t i=0;i<pieces.size();++i) {
+      for (int f=0;f<orientations;++f) {
+        group.colours[i][f] = Megaminx::colours[group.facets[pieces[i]][f] / 10];
+      }
+    }
+  }
+
+  uint64_t PatternDatabase::size() const
+  {
+    return m_size;
+  }
+
+  // Rank a sub-state
+  // Each group is a partial permutation of the slots followed by the
+  // orientations, and the corner rank is the high part
+  uint64_t PatternDatabase::rank(const SubState& sub) const
+  {
+    uint64_t result = 0;
+    for (int g=0;g<2;++g) {
+      const PieceGroup& group = m_groups[g];
+      int count = (int)group.pieces.size();
+      uint64_t permutation = 0;
+      uint64_t orientation = 0;
+      for (int i=0;i<count;++i) {
+        int digit = sub.slot[g][i];
+        for (int j=0;j<i;++j) {
+          if (sub.slot[g][j] < sub.slot[g][i]) {
+            --digit;
+          }
+        }
+        permutation = permutation * (group.slots - i) + digit;
+        orientation = orientation * group.orientations + sub.orientation[g][i];
+      }
+      uint64_t orientation_count = 1;
+      for (int i=0;i<count;++i) {
+        orientation_count *= group.orientations;
+      }
+      result = result * group.size + permutation * orientation_count + orientation;
+    }
+    return result;
+  }
+
+  void PatternDatabase::unrank(uint64_t rank, SubState& sub) const
+  {
+    for (int g=1;g>=0;--g) {
+      const PieceGroup& group = m_groups[g];
+      int count = (int)group.pieces.size();
+      uint64_t local = rank % group.size;
+      rank /= group.size;
+      for (int i=count-1;i>=0;--i) {
+        sub.orientation[g][i] = (unsigned char)(local % group.orientations);
+        local /= group.orientations;
+      }
+      int digits[30];
+      for (int i=count-1;i>=0;--i) {
+        digits[i] = (int)(local % (group.slots - i));
+        local /= (group.slots - i);
+      }
+      // Each digit counts the free slots to skip
+      uint64_t used = 0;
+      for (int i=0;i<count;++i) {
+        int slot = 0;
+        for (int skip=digits[i];;++slot) {
+          if (used & ((uint64_t)1 << slot)) {
+            continue;
+          }
+          if (skip-- == 0) {
+            break;
+          }
+        }
+        used |= (uint64_t)1 << slot;
+        sub.slot[g][i] = (unsigned char)slot;
+      }
+    }
+  }
+
+  // Apply a move to a sub-state
+  void PatternDatabase::turn(const SubState& sub, Megaminx::Move m, SubState& result) const
+  {
+    for (int g=0;g<2;++g) {
+      const PieceGroup& group = m_groups[g];
+      for (size_t i=0;i<group.pieces.size();++i) {
+        int slot = sub.slot[g][i];
+        int orientation = sub.orientation[g][i] + group.twist[m][slot];
+        result.slot[g][i] = group.to[m][slot];
+        result.orientation[g][i] = (unsigned char)(orientation % group.orientations);
+      }
+    }
+  }
+
+  // Rank the sub-state of a state
+  uint64_t PatternDatabase::rank(const Megaminx::CubieState& state) const
+  {
+    SubState sub;
+    for (int g=0;g<2;++g) {
+      const PieceGroup& group = m_groups[g];
+      for (size_t i=0;i<group.pieces.size();++i) {
+        for (int slot=0;slot<group.slots;++slot) {
+          int piece = g == 0 ? state.corner(slot) : state.edge(slot);
+          if (piece == group.pieces[i]) {
+            sub.slot[g][i] = (unsigned char)slot;
+            sub.orientation[g][i] = (unsigned char)(g == 0 ?
+              state.corner_orientation(slot) : state.edge_orientation(slot));
+            break;
+          }
+        }
+      }
+    }
+    return rank(sub);
+  }
+
+  // Only the tracked pieces are looked for, so this is much cheaper than
+  // converting the whole state to a CubieState
+  uint64_t PatternDatabase::rank(const Megaminx::MegaminxState& state) const
+  {
+    const char* facets = state.data();
+    SubState sub;
+    for (int g=0;g<2;++g) {
+      const PieceGroup& group = m_groups[g];
+      int n = group.orientations;
+      for (size_t i=0;i<group.pieces.size();++i) {
+        const char* colours = group.colours[i];
+        bool found = false;
+        for (int slot=0;slot<group.slots && !found;++slot) {
+          const unsigned char* slot_facets = group.facets[slot];
+          // The orientation is where the piece's first facet is in the slot
+          for (int t=0;t<n && !found;++t) {
+            found = facets[slot_facets[t]] == colours[0] &&
+              facets[slot_facets[(t+1)%n]] == colours[1] &&
+              (n == 2 || facets[slot_facets[(t+2)%n]] == colours[2]);
+            if (found) {
+              sub.slot[g][i] = (unsigned char)slot;
+              sub.orientation[g][i] = (unsigned char)t;
+            }
+          }
+        }
+        assert(found);
+      }
+    }
+    return rank(sub);
+  }
+
+  int PatternDatabase::distance(uint64_t rank) const
+  {
+    assert(m_distances);
+    assert(rank < m_size);
+    return get_distance(m_distances, rank);
+  }
+
+  int PatternDatabase::estimate(const Megaminx::MegaminxState& state) const
+  {
+    return distance(rank(state));
+  }
+
+  const std::vector<uint64_t>& PatternDatabase::level_counts() const
+  {
+    return m_level_counts;
+  }
+
+  // Generate the table
+  bool PatternDatabase::generate(const std::string& filename, unsigned int threads, int levels)
+  {
+    threads = thread_count(threads);
+    m_mapped.reset();
+    if (restore(filename)) {
+      m_distances = m_table.data();
+      return true;
+    }
+    if (m_level_counts.empty()) {
+      // Start from the solved sub-state
+      m_table.assign((size_t)((m_size + 1) / 2), 0xFF);
+      set_distance(m_table.data(), rank(Megaminx::CubieState()), 0);
+      m_level_counts.assign(1, 1);
+      save(filename, false);
+    }
+    m_distances = m_table.data();
+    for (int done=0;levels==0 || done<levels;++done) {
+      int depth = (int)m_level_counts.size() - 1;
+      uint64_t found = depth + 1 < unknown ? expand_level(depth, threads) : 0;
+      if (found == 0) {
+        save(filename, true);
+        return true;
+      }
+      m_level_counts.push_back(found);
+      save(filename, false);
+    }
+    return false;
+  }
+
+  // Find every sub-state one move further from solved
+  uint64_t PatternDatabase::expand_level(int depth, unsigned int threads)
+  {
+    unsigned char* table = m_table.data();
+    uint64_t known = 0;
+    for (uint64_t count : m_level_counts) {
+      known += count;
+    }
+    // Pushing from the last level is quicker while it is small. Once it is
+    // big it is quicker to look for the unreached sub-states that are a
+    // move from it
+    bool push = m_level_counts[depth] * Megaminx::num_moves < m_size - known;
+    uint64_t words = (m_size + 63) / 64;
+    std::unique_ptr<std::atomic<uint64_t>[]> marks(new std::atomic<uint64_t>[(size_t)words]);
+    for (uint64_t w=0;w<words;++w) {
+      marks[w].store(0, std::memory_order_relaxed);
+    }
+    auto mark = [&marks](uint64_t rank) {
+      marks[rank >> 6].fetch_or((uint64_t)1 << (rank & 63), std::memory_order_relaxed);
+    };
+
+    // Mark the new sub-states. The table is only read
+    parallel_for(m_size, threads, [&](uint64_t begin, uint64_t end) {
+      SubState sub;
+      SubState child;
+      for (uint64_t r=begin;r<end;++r) {
+        int distance = get_distance(table, r);
+        if (distance != (push ? depth : unknown)) {
+          continue;
+        }
+        unrank(r, sub);
+        for (Megaminx::Move m=0;m<Megaminx::num_moves;++m) {
+          turn(sub, m, child);
+          uint64_t c = rank(child);
+          if (push) {
+            if (get_distance(table, c) == unknown) {
+              mark(c);
+            }
+          } else if (get_distance(table, c) == depth) {
+            mark(r);
+            break;
+          }
+        }
+      }
+    });
+
+    // Write them to the table. Each thread has its own bytes
+    std::vector<uint64_t> counts(threads, 0);
+    uint64_t share = thread_share(m_size, threads);
+    parallel_for(m_size, threads, [&](uint64_t begin, uint64_t end) {
+      uint64_t count = 0;
+      for (uint64_t w=begin/64;w*64<end;++w) {
+        uint64_t bits = marks[w].load(std::memory_order_relaxed);
+        for (int b=0;bits;++b,bits>>=1) {
+          uint64_t r = w * 64 + b;
+          if ((bits & 1) && get_distance(table, r) == unknown) {
+            set_distance(table, r, depth + 1);
+            ++count;
+          }
+        }
+      }
+      counts[begin / share] = count;
+    });
+    uint64_t found = 0;
+    for (uint64_t count : counts) {
+      found += count;
+    }
+    return found;
+  }
+
+  // Save the table, replacing the file only once it is all written
+  void PatternDatabase::save(const std::string& filename, bool complete) const
+  {
+    TableHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, magic, sizeof(magic));
+    header.version = version;
+    header.complete = complete ? 1 : 0;
+    header.num_corners = (uint32_t)m_groups[0].pieces.size();
+    header.num_edges = (uint32_t)m_groups[1].pieces.size();
+    std::copy(m_groups[0].pieces.begin(), m_groups[0].pieces.end(), header.corners);
+    std::copy(m_groups[1].pieces.begin(), m_groups[1].pieces.end(), header.edges);
+    header.size = m_size;
+    header.num_levels = m_level_counts.size();
+    std::copy(m_level_counts.begin(), m_level_counts.end(), header.level_counts);
+
+    std::string temp = filename + ".tmp";
+    {
+      std::ofstream out(temp.c_str(), std::ios::binary);
+      if (!out.good()) {
+        throw pattern_database_error("Error opening pattern database to write: " + temp);
+      }
+      char padded[header_size] = {};
+      memcpy(padded, &header, sizeof(header));
+      out.write(padded, header_size);
+      out.write((const char*)m_table.data(), m_table.size());
+      if (!out.good()) {
+        throw pattern_database_error("Error writing pattern database: " + temp);
+      }
+    }
+    remove(filename.c_str());
+    if (rename(temp.c_str(), filename.c_str()) != 0) {
+      throw pattern_database_error("Error renaming pattern database: " + temp);
+    }
+  }
+
+  namespace {
+    // Check a header is for the same table
+    void check_header(const TableHeader& header, const std::vector<int>& corners,
+      const std::vector<int>& edges, uint64_t size, const std::string& filename)
+    {
+      if (memcmp(header.magic, magic, sizeof(magic)) != 0 || header.version != version) {
+        throw pattern_database_error("Not a pattern database: " + filename);
+      }
+      if (header.size != size ||
+        header.num_corners != corners.size() ||
+        header.num_edges != edges.size() ||
+        !std::equal(corners.begin(), corners.end(), header.corners) ||
+        !std::equal(edges.begin(), edges.end(), header.edges) ||
+        header.num_levels == 0 || header.num_levels > max_levels) {
+        throw pattern_database_error("Pattern database is for different pieces: " + filename);
+      }
+    }
+  }
+
+  // Restore a table saved part way through
+  // Returns if the table is complete
+  bool PatternDatabase::restore(const std::string& filename)
+  {
+    m_level_counts.clear();
+    std::ifstream in(filename.c_str(), std::ios::binary);
+    if (!in.good()) {
+      return false;
+    }
+    char padded[header_size];
+    TableHeader header;
+    in.read(padded, header_size);
+    memcpy(&header, padded, sizeof(header));
+    check_header(header, m_groups[0].pieces, m_groups[1].pieces, m_size, filename);
+    m_table.resize((size_t)((m_size + 1) / 2));
+    in.read((char*)m_table.data(), m_table.size());
+    if (!in.good()) {
+      throw pattern_database_error("Pattern database is truncated: " + filename);
+    }
+    m_level_counts.assign(header.level_counts, header.level_counts + header.num_levels);
+    return header.complete != 0;
+  }
+
+  // Map a complete table
+  void PatternDatabase::load(const std::string& filename)
+  {
+    std::unique_ptr<Utils::MappedFile> mapped(new Utils::MappedFile(filename));
+    if (mapped->size() < header_size) {
+      throw pattern_database_error("Not a pattern database: " + filename);
+    }
+    TableHeader header;
+    memcpy(&header, mapped->data(), sizeof(header));
+    check_header(header, m_groups[0].pieces, m_groups[1].pieces, m_size, filename);
+    if (!header.complete) {
+      throw pattern_database_error("Pattern database is not complete: " + filename);
+    }
+    if (mapped->size() < header_size + (m_size + 1) / 2) {
+      throw pattern_database_error("Pattern database is truncated: " + filename);
+    }
+    m_level_counts.assign(header.level_counts, header.level_counts + header.num_levels);
+    m_mapped.swap(mapped);
+    m_distances = m_mapped->data() + header_size;
+    std::vector<unsigned char>().swap(m_table);
+  }
+}
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include "heuristic.h"
+#include "moves.h"
+
+// Predeclarations
+namespace Megaminx {
+  class CubieState;
+}
+namespace Utils {
+  class MappedFile;
+}
+
+namespace Solver {
+
+  /**
+   * Exact distances to solved for a subset of the pieces
+   *
+   * The sub-state is where each chosen corner and edge piece is and how
+   * it is twisted or flipped, ignoring every other piece. Sub-states are
+   * ranked by a perfect hash so the table is a flat array with one 4 bit
+   * distance per sub-state, two to a byte.
+   *
+   * The table is generated by a breadth first search outwards from
+   * solved over the sub-states. Each level is expanded across all cores
+   * and the whole table is saved after every level, so an interrupted
+   * generation carries on from the last level saved. A finished table is
+   * mapped straight from its file for lookups.
+   *
+   * Distances of 15 or more are stored as 15 so the estimate stays
+   * admissible.
+   */
+  class PatternDatabase : public Heuristic {
+    public:
+      // Distance stored for sub-states not yet reached
+      static const int unknown = 15;
+
+      /**
+       * Constructor
+       * @param corners The corner pieces to track 0 -> 19
+       * @param edges The edge pieces to track 0 -> 29
+       */
+      PatternDatabase(const std::vector<int>& corners, const std::vector<int>& edges);
+
+      // Destructor
+      ~PatternDatabase();
+
+      // Number of sub-states and so entries in the table
+      uint64_t size() const;
+
+      // Rank of the sub-state of a state 0 -> size()-1
+      uint64_t rank(const Megaminx::CubieState& state) const;
+      uint64_t rank(const Megaminx::MegaminxState& state) const;
+
+      // Distance to solved of a ranked sub-state
+      // Only valid once the table has been generated or loaded
+      int distance(uint64_t rank) const;
+
+      // Distance to solved of the sub-state of a state
+      int estimate(const Megaminx::MegaminxState& state) const override;
+
+      /**
+       * Generate the table into a file
+       * If the file already holds part of the table for the same pieces
+       * the generation carries on from the last level saved.
+       * The table is usable once this returns true
+       * @param filename The table file
+       * @param threads Number of threads. 0 uses one per core
+       * @param levels The most levels to generate before returning. 0 for all
+       * @return If the table is complete
+       */
+      bool generate(const std::string& filename, unsigned int threads = 0, int levels = 0);
+
+      /**
+       * Map a complete table from a file
+       * Throws a Solver::pattern_database_error if the file is not a
+       * complete table for the same pieces
+       * @param filename The table file
+       */
+      void load(const std::string& filename);
+
+      // Number of sub-states at each distance
+      const std::vector<uint64_t>& level_counts() const;
+
+    protected:
+    private:
+      // Not copyable
+      PatternDatabase(const PatternDatabase&);
+      PatternDatabase& operator=(const PatternDatabase&);
+
+      // Where the pieces of one kind are
+      struct PieceGroup {
+        int slots;
+        int orientations;
+        std::vector<int> pieces;
+        uint64_t size;
+        // Slot a move takes a piece to and the orientation it adds
+        unsigned char to[Megaminx::num_moves][30];
+        unsigned char twist[Megaminx::num_moves][30];
+        // Facets of each slot and the solved colours of each tracked
+        // piece, to find the pieces straight from the facets
+        unsigned char facets[30][3];
+        char colours[30][3];
+      };
+
+      // The tracked pieces by slot and orientation
+      struct SubState {
+        unsigned char slot[2][30];
+        unsigned char orientation[2][30];
+      };
+
+      void init_group(PieceGroup& group, int slots, int orientations,
+        const std::vector<int>& pieces, bool corners);
+      uint64_t rank(const SubState& sub) const;
+      void unrank(uint64_t rank, SubState& sub) const;
+      void turn(const SubState& sub, Megaminx::Move m, SubState& result) const;
+
+      // Expand one level of the search across the threads
+      uint64_t expand_level(int depth, unsigned int threads);
+
+      // Save and restore the table and the levels done
+      void save(const std::string& filename, bool complete) const;
+      bool restore(const std::string& filename);
+
+      PieceGroup m_groups[2];
+      uint64_t m_size;
+      std::vector<unsigned char> m_table;
+      std::unique_ptr<Utils::MappedFile> m_mapped;
+      const unsigned char* m_distances;
+      std::vector<uint64_t> m_level_counts;
+  };
+
+}
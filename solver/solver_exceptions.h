@@ -0,0 +1,18 @@
+#pragma once
+
+#include "exceptions.h"
+
+namespace Solver {
+
+  // Exception thrown if a search does not find what it is looking for
+  DERIVED_EXCEPTION(not_found);
+
+  // Exception thrown if a pattern database file is not usable
+  DERIVED_EXCEPTION(pattern_database_error);
+
+  // Exception thrown if a batch file cannot be read or written
+  DERIVED_EXCEPTION(batch_error);
+
+  // Exception thrown if a search cannot read or write its files
+  DERIVED_EXCEPTION(search_file_error);
+}
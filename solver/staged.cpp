@@ -0,0 +1,136 @@
+#include "staged.h"
+#include "solver_exceptions.h"
+#include "moves.h"
+#include "megaminx.h"
+#include <assert.h>
+
+namespace Solver {
+
+  namespace {
+    const Megaminx::MegaminxState solved_state;
+
+    // A move moves 25 facets. Stage targets compare facets with their
+    // solved place rather than their face colour so any of them may count
+    const int facets_moved = 25;
+
+    // Fewest moves that could put right some mismatched facets
+    int lower_bound(int mismatches)
+    {
+      return (mismatches + facets_moved - 1) / facets_moved;
+    }
+  }
+
+  // Constructor
+  StagedSolver::StagedSolver(const std::vector<Stage>& stages)
+    : m_stages(stages),
+      m_nodes(0)
+  {
+  }
+
+  // Solve each stage in turn
+  bool StagedSolver::search(const Megaminx::MegaminxState& start)
+  {
+    m_solution = Megaminx::Algorithm();
+    m_stage_solutions.clear();
+    m_nodes = 0;
+    Megaminx::MegaminxState state(start);
+    std::vector<Megaminx::Move> all;
+    for (const Stage& stage : m_stages) {
+      bool found = false;
+      for (int depth=0;depth<=stage.max_depth && !found;++depth) {
+        m_moves.clear();
+        found = bounded_search(state, Megaminx::sequence_start, stage.mask, depth);
+      }
+      if (!found) {
+        return false;
+      }
+      // The search leaves the state at the end of the stage
+      all.insert(all.end(), m_moves.begin(), m_moves.end());
+      m_stage_solutions.push_back(Megaminx::Algorithm(m_moves));
+      m_solution = Megaminx::Algorithm(all);
+    }
+    return true;
+  }
+
+  // Search to a fixed depth for one stage
+  bool StagedSolver::bounded_search(Megaminx::MegaminxState& state,
+    Megaminx::SequenceState sequence, const Megaminx::FacetMask& mask, int depth)
+  {
+    int mismatches = state.mismatches(solved_state, mask);
+    if (mismatches == 0) {
+      return true;
+    }
+    if (lower_bound(mismatches) > depth) {
+      return false;
+    }
+    ++m_nodes;
+    const Megaminx::SequenceSuccessors& successors = Megaminx::sequence_successors(sequence);
+    for (int i=0;i<successors.count;++i) {
+      Megaminx::Move m = successors.moves[i];
+      state.turn(m);
+      m_moves.push_back(m);
+      if (bounded_search(state, successors.next[i], mask, depth - 1)) {
+        return true;
+      }
+      m_moves.pop_back();
+      state.undo_move(m);
+    }
+    return false;
+  }
+
+  // Find a solution
+  Megaminx::Algorithm StagedSolver::solve(const Megaminx::MegaminxState& start)
+  {
+    if (!search(start)) {
+      const Stage& stage = m_stages[m_stage_solutions.size()];
+      throw not_found("Stage " + stage.name + " not solved within " +
+        std::to_string(stage.max_depth) + " moves");
+    }
+    return m_solution;
+  }
+
+  // Stages that add one piece at a time
+  std::vector<Stage> StagedSolver::layer_stages(const std::vector<int>& faces, int max_depth)
+  {
+    std::vector<Stage> stages;
+    Megaminx::FacetMask mask;
+    for (int face : faces) {
+      std::string colour(1, Megaminx::colours[face]);
+      for (int slot : Megaminx::face_edges(face)) {
+        Megaminx::FacetMask piece = Megaminx::edge_mask(slot);
+        if ((mask & piece) != piece) {
+          mask |= piece;
+          stages.push_back({colour + " edge " + std::to_string(slot), mask, max_depth});
+        }
+      }
+      for (int slot : Megaminx::face_corners(face)) {
+        Megaminx::FacetMask piece = Megaminx::corner_mask(slot);
+        if ((mask & piece) != piece) {
+          mask |= piece;
+          stages.push_back({colour + " corner " + std::to_string(slot), mask, max_depth});
+        }
+      }
+    }
+    return stages;
+  }
+
+  const Megaminx::Algorithm& StagedSolver::solution() const
+  {
+    return m_solution;
+  }
+
+  const std::vector<Megaminx::Algorithm>& StagedSolver::stage_solutions() const
+  {
+    return m_stage_solutions;
+  }
+
+  size_t StagedSolver::nodes() const
+  {
+    return m_nodes;
+  }
+
+  const std::vector<Stage>& StagedSolver::stages() const
+  {
+    return m_stages;
+  }
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include "state.h"
+#include "algorithm.h"
+#include "facet_mask.h"
+#include "move_sequence.h"
+
+namespace Solver {
+
+  /**
+   * One step of a staged solve
+   * The mask holds every facet that must be solved at the end of the
+   * stage, including those of earlier stages, so later stages are free
+   * to move solved pieces as long as they put them back.
+   */
+  struct Stage {
+    std::string name;
+    Megaminx::FacetMask mask;
+    int max_depth;
+  };
+
+  /**
+   * Solve a state through a list of subgoals
+   *
+   * Each stage is an iterative deepening search, bounded by the depth of
+   * the stage, for the shortest sequence that makes the facets in its
+   * mask match the solved state. Only canonical move sequences are tried
+   * and a branch is cut off once the mismatched facets could not be put
+   * right in the moves left. The bound on each stage bounds the work for
+   * every solve, at the cost of solutions longer than optimal.
+   */
+  class StagedSolver {
+    public:
+      /**
+       * Constructor
+       * @param stages The subgoals to solve in order
+       */
+      explicit StagedSolver(const std::vector<Stage>& stages);
+
+      /**
+       * Search for a solution through every stage
+       * @param start The state to solve
+       * @return If every stage was solved within its depth
+       */
+      bool search(const Megaminx::MegaminxState& start);
+
+      /**
+       * Find a solution through every stage
+       * Throws a Solver::not_found naming the first stage that could not
+       * be solved within its depth
+       * @param start The state to solve
+       */
+      Megaminx::Algorithm solve(const Megaminx::MegaminxState& start);
+
+      // The moves of all the stages solved by the last search
+      const Megaminx::Algorithm& solution() const;
+
+      // The moves of each stage solved by the last search
+      const std::vector<Megaminx::Algorithm>& stage_solutions() const;
+
+      // Total nodes expanded by the last search
+      size_t nodes() const;
+
+      // The stages of the solve
+      const std::vector<Stage>& stages() const;
+
+      /**
+       * Build stages that solve the pieces of some faces one at a time
+       * The edges of each face go in before its corners, and pieces
+       * already solved by an earlier face are skipped
+       * @param faces The face indices 0 -> 11 in the order to solve them
+       * @param max_depth The depth of each stage
+       */
+      static std::vector<Stage> layer_stages(const std::vector<int>& faces, int max_depth);
+
+    protected:
+    private:
+      // Depth first search to a depth for the facets in a mask
+      bool bounded_search(Megaminx::MegaminxState& state, Megaminx::SequenceState sequence,
+        const Megaminx::FacetMask& mask, int depth);
+
+      std::vector<Stage> m_stages;
+      size_t m_nodes;
+      std::vector<Megaminx::Move> m_moves;
+      Megaminx::Algorithm m_solution;
+      std::vector<Megaminx::Algorithm> m_stage_solutions;
+  };
+
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "state.h"
+#include <set>
+#include <string>
+#include <vector>
+
+// Shared by the search tests to check what they visit
+namespace {
+  // Number of new states at each depth from a state found the slow way
+  std::vector<size_t> brute_force_levels(const Megaminx::MegaminxState& start, int depth)
+  {
+    std::set<std::string> seen;
+    std::vector<Megaminx::MegaminxState> level(1, start);
+    seen.insert(level[0].str());
+    std::vector<size_t> sizes(1, 1);
+    for (int d=1;d<=depth;++d) {
+      std::vector<Megaminx::MegaminxState> next;
+      for (const Megaminx::MegaminxState& state : level) {
+        for (Megaminx::Move m=0;m<Megaminx::num_moves;++m) {
+          Megaminx::MegaminxState child(state);
+          child.turn(m);
+          if (seen.insert(child.str()).second) {
+            next.push_back(child);
+          }
+        }
+      }
+      sizes.push_back(next.size());
+      level.swap(next);
+    }
+    return sizes;
+  }
+}
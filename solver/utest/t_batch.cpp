@@ -0,0 +1,166 @@
+#include <gtest/gtest.h>
+#include "batch.h"
+#include "ida_star.h"
+#include "heuristic.h"
+#include "solver_exceptions.h"
+#include "DBCache.h"
+#include "state.h"
+#include <atomic>
+#include <sstream>
+#include <fstream>
+#include <vector>
+#include <stdio.h>
+
+namespace {
+  Solver::BatchSolver::SolveFunction ida_solver(std::atomic<int>* calls = nullptr)
+  {
+    return [calls](const Megaminx::MegaminxState& state) {
+      if (calls) {
+        ++*calls;
+      }
+      Solver::MisplacedFacetsHeuristic h;
+      Solver::IdaStar ida(h);
+      return ida.solve(state, 4);
+    };
+  }
+
+  // Split the output into its lines and their fields
+  std::vector<std::vector<std::string>> read_results(const std::string& output)
+  {
+    std::vector<std::vector<std::string>> results;
+    std::istringstream in(output);
+    std::string line;
+    while (std::getline(in, line)) {
+      std::vector<std::string> fields;
+      std::istringstream fields_in(line);
+      std::string field;
+      while (std::getline(fields_in, field, '\t')) {
+        fields.push_back(field);
+      }
+      // An empty solution leaves nothing after the last tab
+      fields.resize(4);
+      results.push_back(fields);
+    }
+    return results;
+  }
+}
+
+TEST(BatchSolverTest,parse_scramble)
+{
+  Megaminx::MegaminxState expected;
+  Megaminx::Algorithm("x> Y<").apply(expected);
+  EXPECT_EQ(Solver::BatchSolver::parse_scramble("x> Y<"), expected);
+  EXPECT_EQ(Solver::BatchSolver::parse_scramble(expected.str()), expected);
+  EXPECT_THROW(Solver::BatchSolver::parse_scramble("nonsense"), Megaminx::parse_error);
+  EXPECT_THROW(Solver::BatchSolver::parse_scramble("q> x<"), Megaminx::invalid_instruction);
+}
+
+TEST(BatchSolverTest,run)
+{
+  std::string file = "./t_batch_04.db";
+  remove(file.c_str());
+  Megaminx::MegaminxState state;
+  Megaminx::Algorithm("G> r> k<").apply(state);
+  std::istringstream in(
+    "# Some scrambles\n"
+    "x> Y<\n"
+    "\n" +
+    state.str() + "\n"
+    "nonsense\n"
+    "x> Y<\n"
+    "x> b< Y> G<2 r>\n"
+    "w> w<\n");
+  std::ostringstream out;
+  std::atomic<int> calls(0);
+  {
+    Utils::DBCache cache(file);
+    Solver::BatchSolver batch(ida_solver(&calls), &cache, 3, 2);
+    EXPECT_EQ(batch.threads(), 3u);
+    EXPECT_EQ(batch.run(in, out), 6u);
+    EXPECT_EQ(batch.solved(), 3u);
+    EXPECT_EQ(batch.cached(), 1u);
+    EXPECT_EQ(batch.failed(), 2u);
+  }
+  remove(file.c_str());
+
+  // Results come out in input order
+  std::vector<std::vector<std::string>> results = read_results(out.str());
+  ASSERT_EQ(results.size(), 6u);
+  const char* lines[] = {"2", "4", "5", "6", "7", "8"};
+  const char* statuses[] = {"solved", "solved", "failed", "cached", "failed", "solved"};
+  for (size_t i=0;i<results.size();++i) {
+    ASSERT_EQ(results[i].size(), 4u);
+    EXPECT_EQ(results[i][0], lines[i]);
+    EXPECT_EQ(results[i][1], statuses[i]);
+    EXPECT_GE(std::stod(results[i][2]), 0.0);
+  }
+  EXPECT_EQ(results[0][3].empty(), false);
+  Megaminx::Algorithm(results[1][3]).apply(state);
+  EXPECT_TRUE(state.is_solved());
+  EXPECT_EQ(results[3][3], results[0][3]);
+  // The repeated scramble is answered from the cache, or from the
+  // first one if it is still being solved, and solved states need
+  // no solving
+  EXPECT_EQ(calls, 3);
+  // Too long for the solver
+  EXPECT_NE(results[4][3].find("No solution"), std::string::npos);
+  EXPECT_EQ(results[5][3], "");
+}
+
+TEST(BatchSolverTest,cache)
+{
+  std::string file = "./t_batch_01.db";
+  remove(file.c_str());
+  std::string input = "x> Y<\nG> r> k<\nx> b< Y> G<2 r>\n";
+  {
+    Utils::DBCache cache(file);
+    std::atomic<int> calls(0);
+    Solver::BatchSolver batch(ida_solver(&calls), &cache, 2);
+    std::istringstream in(input);
+    std::ostringstream first;
+    batch.run(in, first);
+    EXPECT_EQ(batch.solved(), 2u);
+    EXPECT_EQ(calls, 3);
+
+    // Solved ones come straight from the cache the second time
+    std::istringstream again(input);
+    std::ostringstream second;
+    batch.run(again, second);
+    EXPECT_EQ(batch.cached(), 2u);
+    EXPECT_EQ(batch.failed(), 1u);
+    EXPECT_EQ(calls, 4);
+    std::vector<std::vector<std::string>> a = read_results(first.str());
+    std::vector<std::vector<std::string>> b = read_results(second.str());
+    ASSERT_EQ(b.size(), 3u);
+    EXPECT_EQ(b[0][1], "cached");
+    EXPECT_EQ(b[0][3], a[0][3]);
+    EXPECT_EQ(b[1][3], a[1][3]);
+  }
+  remove(file.c_str());
+}
+
+TEST(BatchSolverTest,files)
+{
+  std::string input = "./t_batch_02.txt";
+  std::string output = "./t_batch_03.txt";
+  {
+    std::ofstream out(input.c_str());
+    out << "x> Y<\n";
+  }
+  Solver::BatchSolver batch(ida_solver(), nullptr, 1);
+  EXPECT_EQ(batch.run(input, output), 1u);
+  {
+    std::ifstream in(output.c_str());
+    std::string line;
+    EXPECT_TRUE(std::getline(in, line).good());
+    EXPECT_EQ(line.substr(0, 8), "1\tsolved");
+  }
+  EXPECT_THROW(batch.run("./t_batch_missing.txt", output), Solver::batch_error);
+  remove(input.c_str());
+  remove(output.c_str());
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest( &argc, argv );
+  return RUN_ALL_TESTS();
+}
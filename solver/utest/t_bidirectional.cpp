@@ -0,0 +1,122 @@
+#include <gtest/gtest.h>
+#include "bidirectional.h"
+#include "breadth_first.h"
+#include "solver_exceptions.h"
+#include "DBCache.h"
+#include "state.h"
+#include "utest/scramble.h"
+#include <string>
+#include <stdlib.h>
+#include <filesystem>
+namespace fs = std::experimental::filesystem;
+
+#define MKDIR(dirname) \
+  fs::create_directory(dirname)
+
+#define RMDIR(directory) \
+  fs::remove_all(directory)
+
+TEST(BidirectionalSearchTest,solved)
+{
+  std::string dir = "t_bidirectional_01";
+  MKDIR(dir);
+  {
+    Utils::DBCache visited(dir + "/visited.db");
+    Solver::BidirectionalSearch search(dir, visited);
+    EXPECT_TRUE(search.solve(Megaminx::MegaminxState(), 3).empty());
+  }
+  RMDIR(dir);
+}
+
+TEST(BidirectionalSearchTest,optimal)
+{
+  // Same length as a plain breadth first search but visits far fewer states
+  srand(14);
+  std::string dir = "t_bidirectional_02";
+  MKDIR(dir);
+  for (int n=0;n<5;++n) {
+    Megaminx::MegaminxState start = scramble(4);
+    std::string index = std::to_string(n);
+    Utils::DBCache bfs_visited(dir + "/bfs" + index + ".db");
+    Utils::DBCache visited(dir + "/bidir" + index + ".db");
+    Solver::BreadthFirstSearch bfs(dir, bfs_visited, 2);
+    Solver::BidirectionalSearch search(dir, visited, 2, 1000);
+    Megaminx::Algorithm expected = bfs.solve(start, 4);
+    Megaminx::Algorithm solution = search.solve(start, 4);
+    EXPECT_EQ(solution.size(), expected.size());
+    EXPECT_EQ(search.solution(), solution);
+    if (expected.size() == 4) {
+      EXPECT_LT(search.visited_count() * 10, bfs.visited_count());
+    }
+    Megaminx::MegaminxState state(start);
+    solution.apply(state);
+    EXPECT_TRUE(state.is_solved());
+  }
+  // No page files are left behind
+  for (const fs::directory_entry& entry : fs::directory_iterator(dir)) {
+    EXPECT_EQ(entry.path().filename().string().find("bidir_"), std::string::npos);
+  }
+  RMDIR(dir);
+}
+
+TEST(BidirectionalSearchTest,both_sides)
+{
+  std::string dir = "t_bidirectional_03";
+  MKDIR(dir);
+  {
+    Utils::DBCache visited(dir + "/visited.db");
+    Solver::BidirectionalSearch search(dir, visited, 3);
+    Megaminx::MegaminxState start;
+    Megaminx::Algorithm("x> Y< G> k< o>").apply(start);
+    Megaminx::MegaminxState goal;
+    Megaminx::Algorithm("w> b<").apply(goal);
+    ASSERT_TRUE(search.search(start, goal, 7));
+    EXPECT_LE(search.solution().size(), 7u);
+    search.solution().apply(start);
+    EXPECT_EQ(start, goal);
+    // Both ends did some of the work
+    EXPECT_GE(search.forward_level_sizes().size(), 2u);
+    EXPECT_GE(search.backward_level_sizes().size(), 2u);
+  }
+  RMDIR(dir);
+}
+
+TEST(BidirectionalSearchTest,not_found)
+{
+  std::string dir = "t_bidirectional_04";
+  MKDIR(dir);
+  {
+    Utils::DBCache visited(dir + "/visited.db");
+    Solver::BidirectionalSearch search(dir, visited);
+    Megaminx::MegaminxState start;
+    Megaminx::Algorithm("x> Y< b>").apply(start);
+    EXPECT_THROW(search.solve(start, 2), Solver::not_found);
+  }
+  RMDIR(dir);
+}
+
+TEST(BidirectionalSearchTest,solve_twice)
+{
+  // The second search does not see the states from the first
+  std::string dir = "t_bidirectional_05";
+  MKDIR(dir);
+  {
+    Utils::DBCache visited(dir + "/visited.db");
+    Solver::BidirectionalSearch search(dir, visited, 2);
+    const char* scrambles[] = {"x> Y< b> G>", "x> Y< b>"};
+    for (const char* scramble : scrambles) {
+      Megaminx::MegaminxState start;
+      Megaminx::Algorithm(scramble).apply(start);
+      Megaminx::Algorithm solution = search.solve(start, 4);
+      EXPECT_EQ(solution.size(), Megaminx::Algorithm(scramble).size());
+      solution.apply(start);
+      EXPECT_TRUE(start.is_solved());
+    }
+  }
+  RMDIR(dir);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest( &argc, argv );
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,138 @@
+#include <gtest/gtest.h>
+#include "breadth_first.h"
+#include "solver_exceptions.h"
+#include "DBCache.h"
+#include "state.h"
+#include "utest/brute_force.h"
+#include <string>
+#include <filesystem>
+namespace fs = std::experimental::filesystem;
+
+#define MKDIR(dirname) \
+  fs::create_directory(dirname)
+
+#define RMDIR(directory) \
+  fs::remove_all(directory)
+
+TEST(BreadthFirstSearchTest,enumerate)
+{
+  std::string dir = "t_breadth_first_01";
+  MKDIR(dir);
+  {
+    Utils::DBCache visited(dir + "/visited.db");
+    Solver::BreadthFirstSearch bfs(dir, visited, 3, 1000);
+    EXPECT_EQ(bfs.threads(), 3u);
+    EXPECT_FALSE(bfs.search(Megaminx::MegaminxState(), 3));
+    std::vector<size_t> expected = brute_force_levels(Megaminx::MegaminxState(), 3);
+    EXPECT_EQ(bfs.level_sizes(), expected);
+    EXPECT_EQ(bfs.level_sizes()[1], 24u);
+    EXPECT_EQ(bfs.visited_count(), 1 + expected[1] + expected[2] + expected[3]);
+    // The frontier was paged to disk and cleaned up afterwards
+    for (const fs::directory_entry& entry : fs::directory_iterator(dir)) {
+      EXPECT_EQ(entry.path().filename().string().find("bfs_frontier"), std::string::npos);
+    }
+  }
+  RMDIR(dir);
+}
+
+TEST(BreadthFirstSearchTest,threads)
+{
+  // The result does not depend on how many threads do the work
+  std::string dir = "t_breadth_first_02";
+  MKDIR(dir);
+  {
+    Utils::DBCache visited1(dir + "/visited1.db");
+    Utils::DBCache visited4(dir + "/visited4.db");
+    Solver::BreadthFirstSearch bfs1(dir, visited1, 1);
+    Solver::BreadthFirstSearch bfs4(dir, visited4, 4);
+    Megaminx::MegaminxState start;
+    start.turn(Megaminx::make_move(3, true));
+    bfs1.search(start, 2);
+    bfs4.search(start, 2);
+    EXPECT_EQ(bfs1.level_sizes(), bfs4.level_sizes());
+  }
+  RMDIR(dir);
+}
+
+TEST(BreadthFirstSearchTest,solve)
+{
+  std::string dir = "t_breadth_first_03";
+  MKDIR(dir);
+  {
+    Utils::DBCache visited(dir + "/visited.db");
+    Solver::BreadthFirstSearch bfs(dir, visited, 2, 500);
+    Megaminx::MegaminxState start;
+    Megaminx::Algorithm scramble("x> Y< Y< b>");
+    scramble.apply(start);
+    Megaminx::Algorithm solution = bfs.solve(start, 5);
+    EXPECT_EQ(solution.size(), 4u);
+    EXPECT_EQ(bfs.solution(), solution);
+    Megaminx::MegaminxState state(start);
+    solution.apply(state);
+    EXPECT_TRUE(state.is_solved());
+  }
+  RMDIR(dir);
+}
+
+TEST(BreadthFirstSearchTest,path_to)
+{
+  std::string dir = "t_breadth_first_04";
+  MKDIR(dir);
+  {
+    Utils::DBCache visited(dir + "/visited.db");
+    Solver::BreadthFirstSearch bfs(dir, visited);
+    bfs.search(Megaminx::MegaminxState(), 2);
+    Megaminx::Algorithm a("G> k<");
+    Megaminx::MegaminxState state;
+    a.apply(state);
+    Megaminx::Algorithm path = bfs.path_to(state);
+    EXPECT_EQ(path.size(), 2u);
+    Megaminx::MegaminxState check;
+    path.apply(check);
+    EXPECT_EQ(check, state);
+    EXPECT_TRUE(bfs.path_to(Megaminx::MegaminxState()).empty());
+    Megaminx::Algorithm("G> k< x>").apply(state);
+    EXPECT_THROW(bfs.path_to(state), Solver::not_found);
+  }
+  RMDIR(dir);
+}
+
+TEST(BreadthFirstSearchTest,not_found)
+{
+  std::string dir = "t_breadth_first_05";
+  MKDIR(dir);
+  {
+    Utils::DBCache visited(dir + "/visited.db");
+    Solver::BreadthFirstSearch bfs(dir, visited);
+    Megaminx::MegaminxState start;
+    Megaminx::Algorithm("x> Y< b>").apply(start);
+    EXPECT_THROW(bfs.solve(start, 2), Solver::not_found);
+  }
+  RMDIR(dir);
+}
+
+TEST(BreadthFirstSearchTest,solve_twice)
+{
+  // The second search does not see the states from the first
+  std::string dir = "t_breadth_first_06";
+  MKDIR(dir);
+  {
+    Utils::DBCache visited(dir + "/visited.db");
+    Solver::BreadthFirstSearch bfs(dir, visited, 2);
+    const char* scrambles[] = {"x> Y< b>", "x> Y<"};
+    for (const char* scramble : scrambles) {
+      Megaminx::MegaminxState start;
+      Megaminx::Algorithm(scramble).apply(start);
+      Megaminx::Algorithm solution = bfs.solve(start, 3);
+      EXPECT_EQ(solution.size(), Megaminx::Algorithm(scramble).size());
+      solution.apply(start);
+      EXPECT_TRUE(start.is_solved());
+    }
+  }
+  RMDIR(dir);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest( &argc, argv );
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+#include "external_bfs.h"
+#include "solver_exceptions.h"
+#include "state.h"
+#include "algorithm.h"
+#include "utest/brute_force.h"
+#include <set>
+#include <string>
+#include <filesystem>
+namespace fs = std::experimental::filesystem;
+
+#define MKDIR(dirname) \
+  fs::create_directory(dirname)
+
+#define RMDIR(directory) \
+  fs::remove_all(directory)
+
+TEST(ExternalBreadthFirstSearchTest,enumerate)
+{
+  std::string dir = "t_external_bfs_01";
+  MKDIR(dir);
+  {
+    // Small runs so every level is merged from several
+    Solver::ExternalBreadthFirstSearch bfs(dir, 3, 1000);
+    EXPECT_EQ(bfs.threads(), 3u);
+    std::vector<size_t> expected = brute_force_levels(Megaminx::MegaminxState(), 3);
+    EXPECT_EQ(bfs.search(Megaminx::MegaminxState(), 3),
+      expected[0] + expected[1] + expected[2] + expected[3]);
+    EXPECT_EQ(bfs.level_sizes(), expected);
+    EXPECT_GT(bfs.run_count(), 3u);
+    // Nothing is left behind
+    EXPECT_TRUE(fs::is_empty(dir));
+  }
+  RMDIR(dir);
+}
+
+TEST(ExternalBreadthFirstSearchTest,visitor)
+{
+  std::string dir = "t_external_bfs_02";
+  MKDIR(dir);
+  {
+    Megaminx::MegaminxState start;
+    Megaminx::Algorithm("G> k<").apply(start);
+    Solver::ExternalBreadthFirstSearch bfs(dir, 2, 500);
+    std::set<std::string> visited;
+    std::vector<size_t> counts(3, 0);
+    int last_depth = 0;
+    Megaminx::PackedState last;
+    bool sorted = true;
+    bfs.search(start, 2, [&](int depth, const Megaminx::PackedState& state) {
+      ++counts[depth];
+      // New states are never seen twice and come in order in each level
+      EXPECT_TRUE(visited.insert(state.key()).second);
+      if (depth == last_depth && depth > 0 && !(last < state)) {
+        sorted = false;
+      }
+      last_depth = depth;
+      last = state;
+    });
+    EXPECT_TRUE(sorted);
+    EXPECT_EQ(counts, brute_force_levels(start, 2));
+    EXPECT_EQ(counts, bfs.level_sizes());
+    EXPECT_EQ(visited.count(Megaminx::PackedState(start).key()), 1u);
+    EXPECT_EQ(visited.count(Megaminx::PackedState().key()), 1u);
+  }
+  RMDIR(dir);
+}
+
+TEST(ExternalBreadthFirstSearchTest,missing_directory)
+{
+  Solver::ExternalBreadthFirstSearch bfs("t_external_bfs_missing", 1);
+  EXPECT_THROW(bfs.search(Megaminx::MegaminxState(), 1), Solver::search_file_error);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest( &argc, argv );
+  return RUN_ALL_TESTS();
+}
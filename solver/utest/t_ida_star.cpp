@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+#include "ida_star.h"
+#include "heuristic.h"
+#include "solver_exceptions.h"
+#include "state.h"
+#include "utest/scramble.h"
+#include <stdlib.h>
+
+TEST(HeuristicTest,misplaced)
+{
+  Solver::MisplacedFacetsHeuristic h;
+  Megaminx::MegaminxState state;
+  EXPECT_EQ(Solver::MisplacedFacetsHeuristic::misplaced(state), 0);
+  EXPECT_EQ(h.estimate(state), 0);
+  state.turn(Megaminx::make_move(0, true));
+  EXPECT_EQ(Solver::MisplacedFacetsHeuristic::misplaced(state), 15);
+  EXPECT_EQ(h.estimate(state), 1);
+}
+
+TEST(HeuristicTest,admissible)
+{
+  srand(12);
+  Solver::MisplacedFacetsHeuristic h;
+  for (int n=0;n<200;++n) {
+    int moves = 1 + rand() % 10;
+    EXPECT_LE(h.estimate(scramble(moves)), moves);
+  }
+}
+
+TEST(IdaStarTest,solved)
+{
+  Solver::MisplacedFacetsHeuristic h;
+  Solver::IdaStar ida(h);
+  EXPECT_TRUE(ida.search(Megaminx::MegaminxState(), 5));
+  EXPECT_TRUE(ida.solution().empty());
+  EXPECT_EQ(ida.str(), "");
+}
+
+TEST(IdaStarTest,solve)
+{
+  Solver::MisplacedFacetsHeuristic h;
+  Solver::IdaStar ida(h);
+  Megaminx::MegaminxState start;
+  Megaminx::Algorithm("x> Y> Y> b<").apply(start);
+  Megaminx::Algorithm solution = ida.solve(start, 6);
+  EXPECT_EQ(solution.size(), 4u);
+  EXPECT_EQ(ida.solution(), solution);
+  Megaminx::MegaminxState state(start);
+  Megaminx::Algorithm(ida.str()).apply(state);
+  EXPECT_TRUE(state.is_solved());
+
+  // Each iteration raises the bound and searches more
+  const std::vector<Solver::IdaStar::Iteration>& iterations = ida.iterations();
+  ASSERT_GE(iterations.size(), 2u);
+  for (size_t i=1;i<iterations.size();++i) {
+    EXPECT_GT(iterations[i].bound, iterations[i-1].bound);
+  }
+  EXPECT_LE(iterations.back().bound, 4.0);
+  EXPECT_GT(ida.nodes(), 0u);
+}
+
+TEST(IdaStarTest,optimal)
+{
+  // A solution is never longer than the scramble
+  srand(13);
+  Solver::MisplacedFacetsHeuristic h;
+  Solver::IdaStar ida(h);
+  for (int n=0;n<5;++n) {
+    Megaminx::MegaminxState start = scramble(3);
+    Megaminx::Algorithm solution = ida.solve(start, 3);
+    EXPECT_LE(solution.size(), 3u);
+    solution.apply(start);
+    EXPECT_TRUE(start.is_solved());
+  }
+}
+
+TEST(IdaStarTest,weighted)
+{
+  Solver::MisplacedFacetsHeuristic h;
+  Solver::IdaStar optimal(h);
+  Solver::IdaStar weighted(h, 2.0);
+  Megaminx::MegaminxState start;
+  Megaminx::Algorithm("x> Y> b< G<").apply(start);
+  optimal.solve(start, 5);
+  Megaminx::Algorithm solution = weighted.solve(start, 8);
+  EXPECT_LE(solution.size(), 2 * optimal.solution().size());
+  solution.apply(start);
+  EXPECT_TRUE(start.is_solved());
+}
+
+TEST(IdaStarTest,not_found)
+{
+  Solver::MisplacedFacetsHeuristic h;
+  Solver::IdaStar ida(h);
+  Megaminx::MegaminxState start;
+  Megaminx::Algorithm("x> Y< b>").apply(start);
+  EXPECT_FALSE(ida.search(start, 2));
+  EXPECT_THROW(ida.solve(start, 2), Solver::not_found);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest( &argc, argv );
+  return RUN_ALL_TESTS();
+}
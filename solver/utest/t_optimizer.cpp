@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+#include "optimizer.h"
+#include "staged.h"
+#include "DBCache.h"
+#include "state.h"
+#include "utest/brute_force.h"
+#include "utest/scramble.h"
+#include <string>
+#include <numeric>
+#include <stdlib.h>
+#include <stdio.h>
+
+namespace {
+  // Number of states within a depth found the slow way
+  size_t brute_force_count(int depth)
+  {
+    std::vector<size_t> levels = brute_force_levels(Megaminx::MegaminxState(), depth);
+    return std::accumulate(levels.begin() + 1, levels.end(), (size_t)0);
+  }
+
+  Megaminx::MegaminxState effect(const Megaminx::Algorithm& algorithm)
+  {
+    Megaminx::MegaminxState state;
+    algorithm.apply(state);
+    return state;
+  }
+}
+
+TEST(SolutionOptimizerTest,build)
+{
+  std::string file = "./t_optimizer_01.db";
+  remove(file.c_str());
+  {
+    Utils::DBCache table(file);
+    Solver::SolutionOptimizer optimizer(table);
+    EXPECT_EQ(optimizer.build(2), brute_force_count(2));
+    // Building again only adds what is missing
+    EXPECT_EQ(optimizer.build(3), brute_force_count(3) - brute_force_count(2));
+    EXPECT_EQ(optimizer.build(3), 0u);
+
+    Megaminx::Algorithm replacement;
+    EXPECT_TRUE(optimizer.lookup(effect(Megaminx::Algorithm("w> w> w>")), replacement));
+    EXPECT_EQ(replacement.size(), 2u);
+    EXPECT_EQ(effect(replacement), effect(Megaminx::Algorithm("w> w> w>")));
+    EXPECT_TRUE(optimizer.lookup(Megaminx::MegaminxState(), replacement));
+    EXPECT_TRUE(replacement.empty());
+    EXPECT_FALSE(optimizer.lookup(effect(Megaminx::Algorithm("w> r> G> p>")), replacement));
+  }
+  remove(file.c_str());
+}
+
+TEST(SolutionOptimizerTest,optimize)
+{
+  std::string file = "./t_optimizer_02.db";
+  remove(file.c_str());
+  {
+    Utils::DBCache table(file);
+    Solver::SolutionOptimizer optimizer(table, 4);
+    optimizer.build(2);
+
+    // Moves that cancel out, even with others in between
+    Megaminx::Algorithm optimized = optimizer.optimize(Megaminx::Algorithm("x> x< Y>"));
+    EXPECT_EQ(optimized, Megaminx::Algorithm("Y>"));
+    optimized = optimizer.optimize(Megaminx::Algorithm("w> x> w<"));
+    EXPECT_EQ(optimized, Megaminx::Algorithm("x>"));
+    optimized = optimizer.optimize(Megaminx::Algorithm("r> w> w> w> G<"));
+    EXPECT_EQ(optimized.size(), 4u);
+    EXPECT_EQ(optimizer.replacements(), 1u);
+    optimized = optimizer.optimize(Megaminx::Algorithm("r> G> p< G< r<"));
+    EXPECT_EQ(optimized.size(), 5u);
+    EXPECT_EQ(optimizer.replacements(), 0u);
+
+    // Splices can open up more splices
+    optimized = optimizer.optimize(Megaminx::Algorithm("r> w> x> x< w< r<"));
+    EXPECT_TRUE(optimized.empty());
+  }
+  remove(file.c_str());
+}
+
+TEST(SolutionOptimizerTest,staged)
+{
+  // Staged solutions get shorter but still do the same thing
+  std::string file = "./t_optimizer_03.db";
+  remove(file.c_str());
+  {
+    srand(19);
+    Utils::DBCache table(file);
+    Solver::SolutionOptimizer optimizer(table);
+    optimizer.build(3);
+    Solver::StagedSolver solver(Solver::StagedSolver::layer_stages({0}, 6));
+    for (int n=0;n<5;++n) {
+      Megaminx::MegaminxState start = scramble(6);
+      Megaminx::Algorithm solution = solver.solve(start);
+      Megaminx::Algorithm optimized = optimizer.optimize(solution);
+      EXPECT_LE(optimized.size(), solution.size());
+      EXPECT_EQ(effect(optimized), effect(solution));
+    }
+  }
+  remove(file.c_str());
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest( &argc, argv );
+  return RUN_ALL_TESTS();
+}
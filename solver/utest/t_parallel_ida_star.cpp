@@ -0,0 +1,76 @@
+#include <gtest/gtest.h>
+#include "parallel_ida_star.h"
+#include "ida_star.h"
+#include "heuristic.h"
+#include "solver_exceptions.h"
+#include "state.h"
+#include "utest/scramble.h"
+#include <stdlib.h>
+
+TEST(ParallelIdaStarTest,solved)
+{
+  Solver::MisplacedFacetsHeuristic h;
+  Solver::ParallelIdaStar ida(h, 4);
+  EXPECT_EQ(ida.threads(), 4u);
+  EXPECT_TRUE(ida.search(Megaminx::MegaminxState(), 5));
+  EXPECT_TRUE(ida.solution().empty());
+  EXPECT_EQ(ida.str(), "");
+}
+
+TEST(ParallelIdaStarTest,solve)
+{
+  Solver::MisplacedFacetsHeuristic h;
+  Solver::ParallelIdaStar ida(h, 4);
+  Megaminx::MegaminxState start;
+  Megaminx::Algorithm("x> Y> Y> b<").apply(start);
+  Megaminx::Algorithm solution = ida.solve(start, 6);
+  EXPECT_EQ(solution.size(), 4u);
+  Megaminx::MegaminxState state(start);
+  Megaminx::Algorithm(ida.str()).apply(state);
+  EXPECT_TRUE(state.is_solved());
+  const std::vector<Solver::ParallelIdaStar::Iteration>& iterations = ida.iterations();
+  ASSERT_GE(iterations.size(), 2u);
+  for (size_t i=1;i<iterations.size();++i) {
+    EXPECT_GT(iterations[i].bound, iterations[i-1].bound);
+  }
+}
+
+TEST(ParallelIdaStarTest,matches_serial)
+{
+  // Same optimal lengths as the single threaded search, whatever
+  // order the threads happen to search in
+  srand(16);
+  Solver::MisplacedFacetsHeuristic h;
+  Solver::IdaStar serial(h);
+  for (unsigned int threads : {1u, 2u, 8u}) {
+    Solver::ParallelIdaStar parallel(h, threads, 1.0, 2);
+    for (int n=0;n<5;++n) {
+      Megaminx::MegaminxState start = scramble(4);
+      Megaminx::Algorithm expected = serial.solve(start, 4);
+      Megaminx::Algorithm solution = parallel.solve(start, 4);
+      EXPECT_EQ(solution.size(), expected.size());
+      // Every bound below the last is searched right through
+      ASSERT_EQ(parallel.iterations().size(), serial.iterations().size());
+      for (size_t i=0;i+1<serial.iterations().size();++i) {
+        EXPECT_EQ(parallel.iterations()[i].nodes, serial.iterations()[i].nodes);
+      }
+      solution.apply(start);
+      EXPECT_TRUE(start.is_solved());
+    }
+  }
+}
+
+TEST(ParallelIdaStarTest,not_found)
+{
+  Solver::MisplacedFacetsHeuristic h;
+  Solver::ParallelIdaStar ida(h, 4);
+  Megaminx::MegaminxState start;
+  Megaminx::Algorithm("x> Y< b>").apply(start);
+  EXPECT_FALSE(ida.search(start, 2));
+  EXPECT_THROW(ida.solve(start, 2), Solver::not_found);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest( &argc, argv );
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,219 @@
+#include <gtest/gtest.h>
+#include "pattern_database.h"
+#include "ida_star.h"
+#include "solver_exceptions.h"
+#include "cubie.h"
+#include "state.h"
+#include "utest/scramble.h"
+#include <map>
+#include <set>
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <stdlib.h>
+#include <stdio.h>
+
+namespace {
+  std::vector<int> corners = {0, 1};
+  std::vector<int> edges = {0};
+
+  std::string read_file(const std::string& filename)
+  {
+    std::ifstream in(filename.c_str(), std::ios::binary);
+    std::stringstream contents;
+    contents << in.rdbuf();
+    return contents.str();
+  }
+
+  uint64_t total(const std::vector<uint64_t>& counts)
+  {
+    uint64_t sum = 0;
+    for (uint64_t count : counts) {
+      sum += count;
+    }
+    return sum;
+  }
+}
+
+TEST(PatternDatabaseTest,size)
+{
+  Solver::PatternDatabase corners_only({0, 1}, {});
+  EXPECT_EQ(corners_only.size(), 20u * 19 * 3 * 3);
+  Solver::PatternDatabase pdb(corners, edges);
+  EXPECT_EQ(pdb.size(), 20u * 19 * 9 * 30 * 2);
+}
+
+TEST(PatternDatabaseTest,rank)
+{
+  // States rank the same exactly when the tracked pieces are the same
+  srand(13);
+  Solver::PatternDatabase pdb(corners, edges);
+  std::map<uint64_t,std::string> seen;
+  Megaminx::CubieState state;
+  for (int i=0;i<2000;++i) {
+    state.turn(rand() % Megaminx::num_moves);
+    uint64_t r = pdb.rank(state);
+    ASSERT_LT(r, pdb.size());
+    std::string key;
+    for (int slot=0;slot<Megaminx::CubieState::num_corners;++slot) {
+      if (state.corner(slot) <= 1) {
+        key += std::to_string(state.corner(slot)) + "@" + std::to_string(slot) +
+          "/" + std::to_string(state.corner_orientation(slot)) + " ";
+      }
+    }
+    for (int slot=0;slot<Megaminx::CubieState::num_edges;++slot) {
+      if (state.edge(slot) == 0) {
+        key += "e@" + std::to_string(slot) + "/" + std::to_string(state.edge_orientation(slot));
+      }
+    }
+    auto found = seen.insert(std::make_pair(r, key));
+    ASSERT_EQ(found.first->second, key);
+  }
+  EXPECT_EQ(pdb.rank(Megaminx::MegaminxState()), pdb.rank(Megaminx::CubieState()));
+}
+
+TEST(PatternDatabaseTest,rank_facets)
+{
+  // Ranking straight from the facets matches ranking the pieces
+  srand(15);
+  Solver::PatternDatabase pdb(corners, edges);
+  for (int n=0;n<500;++n) {
+    Megaminx::MegaminxState state = scramble(1 + rand() % 30);
+    ASSERT_EQ(pdb.rank(state), pdb.rank(Megaminx::CubieState(state)));
+  }
+}
+
+TEST(PatternDatabaseTest,generate)
+{
+  std::string file = "./t_pattern_database_01.pdb";
+  remove(file.c_str());
+  {
+    Solver::PatternDatabase pdb(corners, edges);
+    EXPECT_TRUE(pdb.generate(file, 3));
+    // Every placement of so few pieces can be reached
+    EXPECT_EQ(total(pdb.level_counts()), pdb.size());
+    EXPECT_EQ(pdb.level_counts()[0], 1u);
+    EXPECT_EQ(pdb.estimate(Megaminx::MegaminxState()), 0);
+
+    // Distances match a search over whole states as far as it goes
+    std::map<uint64_t,int> nearest;
+    std::set<std::string> seen;
+    std::vector<Megaminx::MegaminxState> level(1);
+    nearest[pdb.rank(level[0])] = 0;
+    for (int depth=1;depth<=3;++depth) {
+      std::vector<Megaminx::MegaminxState> next;
+      for (const Megaminx::MegaminxState& state : level) {
+        for (Megaminx::Move m=0;m<Megaminx::num_moves;++m) {
+          Megaminx::MegaminxState child(state);
+          child.turn(m);
+          if (seen.insert(child.str()).second) {
+            next.push_back(child);
+            nearest.insert(std::make_pair(pdb.rank(child), depth));
+          }
+        }
+      }
+      level.swap(next);
+    }
+    for (const auto& entry : nearest) {
+      ASSERT_EQ(pdb.distance(entry.first), entry.second);
+    }
+  }
+  remove(file.c_str());
+}
+
+TEST(PatternDatabaseTest,admissible)
+{
+  std::string file = "./t_pattern_database_02.pdb";
+  remove(file.c_str());
+  {
+    srand(14);
+    Solver::PatternDatabase pdb(corners, edges);
+    pdb.generate(file, 2);
+    for (int n=0;n<200;++n) {
+      int moves = 1 + rand() % 12;
+      ASSERT_LE(pdb.estimate(scramble(moves)), moves);
+    }
+  }
+  remove(file.c_str());
+}
+
+TEST(PatternDatabaseTest,resume)
+{
+  std::string whole = "./t_pattern_database_03.pdb";
+  std::string parts = "./t_pattern_database_04.pdb";
+  remove(whole.c_str());
+  remove(parts.c_str());
+  {
+    Solver::PatternDatabase pdb(corners, edges);
+    EXPECT_TRUE(pdb.generate(whole, 1));
+
+    // Stop after two levels then carry on in a new object
+    {
+      Solver::PatternDatabase first(corners, edges);
+      EXPECT_FALSE(first.generate(parts, 2, 2));
+      EXPECT_EQ(first.level_counts().size(), 3u);
+    }
+    Solver::PatternDatabase second(corners, edges);
+    EXPECT_TRUE(second.generate(parts, 4));
+    EXPECT_EQ(second.level_counts(), pdb.level_counts());
+    EXPECT_EQ(read_file(parts), read_file(whole));
+
+    // Generating a complete table does nothing
+    EXPECT_TRUE(second.generate(parts));
+    EXPECT_EQ(read_file(parts), read_file(whole));
+  }
+  remove(whole.c_str());
+  remove(parts.c_str());
+}
+
+TEST(PatternDatabaseTest,load)
+{
+  std::string file = "./t_pattern_database_05.pdb";
+  std::string partial = "./t_pattern_database_06.pdb";
+  remove(file.c_str());
+  remove(partial.c_str());
+  {
+    Solver::PatternDatabase generated(corners, edges);
+    generated.generate(file);
+    Solver::PatternDatabase loaded(corners, edges);
+    loaded.load(file);
+    EXPECT_EQ(loaded.level_counts(), generated.level_counts());
+    for (uint64_t r=0;r<loaded.size();r+=7) {
+      ASSERT_EQ(loaded.distance(r), generated.distance(r));
+    }
+
+    // Only a complete table for the same pieces can be loaded
+    Solver::PatternDatabase other({0, 2}, edges);
+    EXPECT_THROW(other.load(file), Solver::pattern_database_error);
+    EXPECT_THROW(other.generate(file), Solver::pattern_database_error);
+    Solver::PatternDatabase unfinished(corners, edges);
+    unfinished.generate(partial, 1, 1);
+    EXPECT_THROW(loaded.load(partial), Solver::pattern_database_error);
+  }
+  remove(file.c_str());
+  remove(partial.c_str());
+}
+
+TEST(PatternDatabaseTest,heuristic)
+{
+  std::string file = "./t_pattern_database_07.pdb";
+  remove(file.c_str());
+  {
+    Solver::PatternDatabase pdb(corners, edges);
+    pdb.generate(file);
+    pdb.load(file);
+    Solver::IdaStar ida(pdb);
+    Megaminx::MegaminxState start;
+    Megaminx::Algorithm("x> Y> b< G<").apply(start);
+    Megaminx::Algorithm solution = ida.solve(start, 5);
+    EXPECT_LE(solution.size(), 4u);
+    solution.apply(start);
+    EXPECT_TRUE(start.is_solved());
+  }
+  remove(file.c_str());
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest( &argc, argv );
+  return RUN_ALL_TESTS();
+}
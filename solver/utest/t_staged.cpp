@@ -0,0 +1,85 @@
+#include <gtest/gtest.h>
+#include "staged.h"
+#include "solver_exceptions.h"
+#include "state.h"
+#include "utest/scramble.h"
+#include <stdlib.h>
+
+TEST(StagedSolverTest,layer_stages)
+{
+  std::vector<Solver::Stage> stages = Solver::StagedSolver::layer_stages({0}, 5);
+  ASSERT_EQ(stages.size(), 10u);
+  EXPECT_EQ(stages[0].name.substr(0, 6), "w edge");
+  EXPECT_EQ(stages[9].name.substr(0, 8), "w corner");
+  for (size_t i=1;i<stages.size();++i) {
+    // Each stage adds one piece to the last
+    EXPECT_EQ(stages[i].mask & stages[i-1].mask, stages[i-1].mask);
+    size_t added = stages[i].mask.count() - stages[i-1].mask.count();
+    EXPECT_EQ(added, i < 5 ? 2u : 3u);
+    EXPECT_EQ(stages[i].max_depth, 5);
+  }
+  EXPECT_EQ(stages.back().mask, Megaminx::face_pieces_mask(0));
+
+  // Pieces shared with an earlier face are not solved twice
+  std::vector<Solver::Stage> two = Solver::StagedSolver::layer_stages({0, 1}, 5);
+  // The next face shares one edge and two corners with the first
+  EXPECT_EQ(two.size(), 10u + 4 + 3);
+  EXPECT_EQ(two.back().mask, Megaminx::face_pieces_mask(0) | Megaminx::face_pieces_mask(1));
+}
+
+TEST(StagedSolverTest,first_face)
+{
+  srand(15);
+  Solver::StagedSolver solver(Solver::StagedSolver::layer_stages({0}, 6));
+  for (int n=0;n<10;++n) {
+    Megaminx::MegaminxState start = scramble(6);
+    Megaminx::Algorithm solution = solver.solve(start);
+    ASSERT_EQ(solver.stage_solutions().size(), 10u);
+    size_t length = 0;
+    for (const Megaminx::Algorithm& stage : solver.stage_solutions()) {
+      length += stage.size();
+    }
+    EXPECT_EQ(solution.size(), length);
+    solution.apply(start);
+    EXPECT_TRUE(start.matches(Megaminx::MegaminxState(), Megaminx::face_pieces_mask(0)));
+    EXPECT_EQ(solver.nodes() > 0, !solution.empty());
+  }
+}
+
+TEST(StagedSolverTest,whole_puzzle)
+{
+  // One stage for every facet is a plain iterative deepening search
+  Solver::StagedSolver solver({{"all", Megaminx::FacetMask().set(), 4}});
+  Megaminx::MegaminxState start;
+  Megaminx::Algorithm("x> Y> b<").apply(start);
+  Megaminx::Algorithm solution = solver.solve(start);
+  EXPECT_EQ(solution.size(), 3u);
+  solution.apply(start);
+  EXPECT_TRUE(start.is_solved());
+
+  // Solved states need no moves
+  EXPECT_TRUE(solver.search(start));
+  EXPECT_TRUE(solver.solution().empty());
+}
+
+TEST(StagedSolverTest,not_found)
+{
+  Solver::StagedSolver solver({
+    {"first", Megaminx::face_mask(0), 2},
+    {"all", Megaminx::FacetMask().set(), 1}});
+  Megaminx::MegaminxState start;
+  Megaminx::Algorithm("w> x> Y> b<").apply(start);
+  EXPECT_FALSE(solver.search(start));
+  EXPECT_EQ(solver.stage_solutions().size(), 1u);
+  try {
+    solver.solve(start);
+    FAIL() << "Expected not_found";
+  } catch (const Solver::not_found& e) {
+    EXPECT_NE(std::string(e.what()).find("all"), std::string::npos);
+  }
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest( &argc, argv );
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,71 @@
+#include <gtest/gtest.h>
+#include "FilePagedQueue.h"
+#include "state.h"
+#include "packed.h"
+#include "utest/scramble.h"
+#include <stdlib.h>
+#include <filesystem>
+namespace fs = std::experimental::filesystem;
+
+#define MKDIR(dirname) \
+  fs::create_directory(dirname)
+
+#define RMDIR(directory) \
+  fs::remove_all(directory)
+
+// The states say how they are queued so nothing else needs including
+static_assert(Utils::QueueSerializer<Megaminx::MegaminxState>::fixed_size == Megaminx::PackedState::num_bytes,
+  "MegaminxState should be queued in its packed form");
+static_assert(Utils::QueueSerializer<Megaminx::PackedState>::fixed_size == Megaminx::PackedState::num_bytes,
+  "PackedState should be queued without its padding");
+
+TEST(StateSerializerTest,encode)
+{
+  srand(22);
+  Megaminx::MegaminxState state = scramble(30);
+  std::string out;
+  Utils::QueueSerializer<Megaminx::MegaminxState>::encode(state, out);
+  Utils::QueueSerializer<Megaminx::PackedState>::encode(Megaminx::PackedState(state), out);
+  ASSERT_EQ(out.size(), 2u * Megaminx::PackedState::num_bytes);
+
+  Megaminx::MegaminxState decoded;
+  Megaminx::PackedState packed;
+  const char* end = out.data() + out.size();
+  const char* pos = Utils::QueueSerializer<Megaminx::MegaminxState>::decode(out.data(), end, decoded);
+  pos = Utils::QueueSerializer<Megaminx::PackedState>::decode(pos, end, packed);
+  EXPECT_EQ(pos, end);
+  EXPECT_EQ(decoded, state);
+  EXPECT_EQ(packed, Megaminx::PackedState(state));
+}
+
+TEST(StateSerializerTest,queue)
+{
+  std::string dir = "t_state_serializer_01";
+  RMDIR(dir);
+  MKDIR(dir);
+  {
+    srand(23);
+    std::vector<Megaminx::MegaminxState> states;
+    Utils::FilePagedQueue<Megaminx::MegaminxState> q(dir, "states", 5);
+    for (int i=0;i<40;++i) {
+      Megaminx::MegaminxState state = scramble(i + 1);
+      states.push_back(state);
+      q.push(state);
+    }
+    q.syncronize();
+    // Pages hold 60 bytes for each state after the header
+    fs::path page = fs::path(dir) / "states1.q";
+    ASSERT_TRUE(fs::exists(page));
+    EXPECT_EQ(fs::file_size(page), sizeof(Utils::QueuePageHeader) + 5 * 60);
+    for (const Megaminx::MegaminxState& expected : states) {
+      ASSERT_EQ(q.front(), expected);
+      q.pop();
+    }
+  }
+  RMDIR(dir);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest( &argc, argv );
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,242 @@
+#pragma once
+#include "ConcurrentFilePagedQueue_def.h"
+#include "FilePagedQueue.h"
+#include <vector>
+#include <chrono>
+#include <algorithm>
+
+namespace Utils {
+
+  template<class T>
+  ConcurrentFilePagedQueue<T>::ConcurrentFilePagedQueue(std::string directory, std::string prefix,
+    size_t page_size, unsigned int read_ahead)
+    : m_dir(directory),
+      m_prefix(prefix),
+      m_page_size(page_size),
+      m_read_ahead(read_ahead),
+      m_count(0),
+      m_files(0)
+  {
+    assert(page_size > 0);
+    assert(read_ahead > 0);
+    assert(!directory.empty());
+    assert(!prefix.empty());
+    if (!fs::is_directory(directory)) {
+      throw std::runtime_error("Invalid directory");
+    }
+  }
+
+  template<class T>
+  bool ConcurrentFilePagedQueue<T>::empty() const
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_pages.empty();
+  }
+
+  template<class T>
+  size_t ConcurrentFilePagedQueue<T>::size() const
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_count;
+  }
+
+  // Get the path to a page file
+  template<class T>
+  std::string ConcurrentFilePagedQueue<T>::page_file(size_t counter) const
+  {
+    fs::path dir = m_dir;
+    fs::path file = m_prefix;
+    file += std::to_string(counter);
+    file += ".q";
+    fs::path full = dir / file;
+    return full.string();
+  }
+
+  // Add a page to the end of the queue
+  template<class T>
+  void ConcurrentFilePagedQueue<T>::push_page(std::shared_ptr<std::queue<T>> records)
+  {
+    std::shared_future<void> oldest;
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      std::shared_ptr<Page> page = std::make_shared<Page>();
+      page->count = records->size();
+      m_count += page->count;
+      if (m_pages.size() <= m_read_ahead) {
+        page->records = records;
+      } else {
+        // Too far back to be needed soon so write it out
+        page->file = page_file(++m_files);
+        std::string file = page->file;
+        page->written = page_io_pool().submit([records, file]() {
+          std::ofstream out(file.c_str(), std::ios::binary);
+          if (!out.good()) {
+            throw std::runtime_error("Error opening queue file to write: " + file);
+          }
+          FilePagedQueue<T>::write_to_stream(out, *records);
+        }).share();
+        while (!m_writes.empty() &&
+          m_writes.front().wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+          m_writes.pop_front();
+        }
+        m_writes.push_back(page->written);
+        if (m_writes.size() > m_read_ahead) {
+          oldest = m_writes.front();
+        }
+      }
+      m_pages.push_back(page);
+    }
+    // Hold back once too many pages are waiting to be written. Any error
+    // comes out when the page is read
+    if (oldest.valid()) {
+      oldest.wait();
+    }
+  }
+
+  // Take the page at the front
+  template<class T>
+  std::shared_ptr<std::queue<T>> ConcurrentFilePagedQueue<T>::pop_page()
+  {
+    std::shared_ptr<Page> page;
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      if (m_pages.empty()) {
+        return nullptr;
+      }
+      read_ahead();
+      page = m_pages.front();
+      m_pages.pop_front();
+      m_count -= page->count;
+    }
+    if (page->records) {
+      return page->records;
+    }
+    // Wait for it outside the lock
+    return page->loaded.get();
+  }
+
+  // Start reading back pages on disk that will be needed soon
+  template<class T>
+  void ConcurrentFilePagedQueue<T>::read_ahead()
+  {
+    // The front page is about to be taken so counts as well
+    size_t limit = std::min(m_pages.size(), (size_t)m_read_ahead + 1);
+    for (size_t i=0;i<limit;++i) {
+      std::shared_ptr<Page> page = m_pages[i];
+      if (page->records || page->loaded.valid()) {
+        continue;
+      }
+      std::string file = page->file;
+      std::shared_future<void> written = page->written;
+      page->loaded = page_io_pool().submit([file, written]() {
+        written.get();
+        std::shared_ptr<std::queue<T>> records = std::make_shared<std::queue<T>>();
+        std::ifstream input(file.c_str(), std::ios::binary);
+        if (!input.good()) {
+          throw std::runtime_error("Error opening queue file to read: " + file);
+        }
+        FilePagedQueue<T>::read_from_stream(input, *records);
+        input.close();
+        // Page file no longer needed
+        remove(file.c_str());
+        return records;
+      }).share();
+    }
+  }
+
+  template<class T>
+  void ConcurrentFilePagedQueue<T>::syncronize()
+  {
+    std::vector<std::shared_future<void>> writes;
+    std::vector<std::shared_future<std::shared_ptr<std::queue<T>>>> reads;
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      for (const std::shared_ptr<Page>& page : m_pages) {
+        if (page->written.valid()) {
+          writes.push_back(page->written);
+        }
+        if (page->loaded.valid()) {
+          reads.push_back(page->loaded);
+        }
+      }
+    }
+    for (const std::shared_future<void>& write : writes) {
+      write.wait();
+    }
+    for (const std::shared_future<std::shared_ptr<std::queue<T>>>& read : reads) {
+      read.wait();
+    }
+  }
+
+  template<class T>
+  ConcurrentFilePagedQueue<T>::~ConcurrentFilePagedQueue()
+  {
+    syncronize();
+    for (const std::shared_ptr<Page>& page : m_pages) {
+      if (page->written.valid() && !page->loaded.valid()) {
+        remove(page->file.c_str());
+      }
+    }
+  }
+
+  template<class T>
+  ConcurrentFilePagedQueue<T>::Producer::Producer(ConcurrentFilePagedQueue& queue)
+    : m_queue(&queue),
+      m_page(std::make_shared<std::queue<T>>())
+  {
+  }
+
+  // Add a record
+  template<class T>
+  void ConcurrentFilePagedQueue<T>::Producer::push(const T& value)
+  {
+    m_page->push(value);
+    if (m_page->size() >= m_queue->m_page_size) {
+      flush();
+    }
+  }
+
+  template<class T>
+  void ConcurrentFilePagedQueue<T>::Producer::flush()
+  {
+    if (!m_page->empty()) {
+      std::shared_ptr<std::queue<T>> page = m_page;
+      m_page = std::make_shared<std::queue<T>>();
+      m_queue->push_page(page);
+    }
+  }
+
+  template<class T>
+  ConcurrentFilePagedQueue<T>::Producer::~Producer()
+  {
+    flush();
+  }
+
+  template<class T>
+  ConcurrentFilePagedQueue<T>::Consumer::Consumer(ConcurrentFilePagedQueue& queue)
+    : m_queue(&queue)
+  {
+  }
+
+  // Take the next record
+  template<class T>
+  bool ConcurrentFilePagedQueue<T>::Consumer::pop(T& value)
+  {
+    while (!m_page || m_page->empty()) {
+      m_page = m_queue->pop_page();
+      if (!m_page) {
+        return false;
+      }
+    }
+    value = std::move(m_page->front());
+    m_page->pop();
+    return true;
+  }
+
+  template<class T>
+  size_t ConcurrentFilePagedQueue<T>::Consumer::taken() const
+  {
+    return m_page ? m_page->size() : 0;
+  }
+
+}
@@ -0,0 +1,150 @@
+#pragma once
+#include "FilePagedQueue_def.h"
+#include <queue>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace Utils {
+
+  /**
+   * Queue paged to disk that many threads can push to and pop from at once
+   *
+   * Each thread works through its own Producer or Consumer. A Producer
+   * fills a page of its own and hands the whole page to the queue once
+   * it is full. A Consumer takes a whole page and pops from it. The lock
+   * is only held to add or remove a page, never for a record or for disk
+   * access. Pages are written and read on the same shared pool of
+   * threads as FilePagedQueue, in the same format.
+   *
+   * The first read_ahead + 1 pages are kept in memory. Pages added after
+   * them are written to disk, and read back once they are among the next
+   * read_ahead pages to be taken. A Producer waits outside the lock while
+   * more than read_ahead pages are waiting to be written.
+   *
+   * Records stay in order from any one Producer, but records taken by
+   * different Consumers may be used in any order. Records in a Producer's
+   * page are not in the queue until it is full, flushed or destroyed.
+   */
+  template<class T>
+  class ConcurrentFilePagedQueue {
+    public:
+      /**
+       * Constructor
+       * @param directory Existing directory for the page files
+       * @param prefix Start of the page file names
+       * @param page_size Number of records in each page
+       * @param read_ahead Number of pages read or written in the background
+       */
+      ConcurrentFilePagedQueue(std::string directory, std::string prefix, size_t page_size,
+        unsigned int read_ahead = 1);
+
+      // Adds records to the queue for one thread
+      class Producer {
+        public:
+          explicit Producer(ConcurrentFilePagedQueue& queue);
+
+          // Add a record, handing the page to the queue once full
+          void push(const T& value);
+
+          // Hand the records in the page to the queue now
+          void flush();
+
+          // Flushes the page
+          ~Producer();
+
+        protected:
+        private:
+          // Not copyable
+          Producer(const Producer&);
+          Producer& operator=(const Producer&);
+
+          ConcurrentFilePagedQueue* m_queue;
+          std::shared_ptr<std::queue<T>> m_page;
+      };
+
+      // Takes records from the queue for one thread
+      class Consumer {
+        public:
+          explicit Consumer(ConcurrentFilePagedQueue& queue);
+
+          /**
+           * Take the next record
+           * Throws a std::runtime_error if its page cannot be read
+           * @param value Set to the record taken
+           * @return False if this consumer and the queue are both empty
+           */
+          bool pop(T& value);
+
+          // Number of records taken from the queue but not yet popped
+          size_t taken() const;
+
+        protected:
+        private:
+          // Not copyable
+          Consumer(const Consumer&);
+          Consumer& operator=(const Consumer&);
+
+          ConcurrentFilePagedQueue* m_queue;
+          std::shared_ptr<std::queue<T>> m_page;
+      };
+
+      // Return if the queue is empty
+      // Records in a Producer's or Consumer's page do not count
+      bool empty() const;
+
+      // Return the number of records in the queue
+      // Records in a Producer's or Consumer's page do not count
+      size_t size() const;
+
+      // Wait for the pages being written and read
+      void syncronize();
+
+      // Waits for the pages being written and read and removes the page
+      // files left
+      ~ConcurrentFilePagedQueue();
+
+    protected:
+    private:
+      // A page in the queue. Only one of records, written or loaded is
+      // needed to get its records
+      struct Page {
+        size_t count;
+        // Set while the page is in memory
+        std::shared_ptr<std::queue<T>> records;
+        // Page file when it has been written out
+        std::string file;
+        std::shared_future<void> written;
+        // Set once it is being read back
+        std::shared_future<std::shared_ptr<std::queue<T>>> loaded;
+      };
+
+      // Not copyable
+      ConcurrentFilePagedQueue(const ConcurrentFilePagedQueue&);
+      ConcurrentFilePagedQueue& operator=(const ConcurrentFilePagedQueue&);
+
+      // Add a page to the end of the queue
+      void push_page(std::shared_ptr<std::queue<T>> records);
+      // Take the page at the front, or nullptr if there is none
+      std::shared_ptr<std::queue<T>> pop_page();
+      // Start reading back the front page and the read_ahead after it if
+      // they are on disk. The lock must be held
+      void read_ahead();
+      // Get the path to a page file
+      std::string page_file(size_t counter) const;
+
+      std::string m_dir;
+      std::string m_prefix;
+      size_t m_page_size;
+      unsigned int m_read_ahead;
+      size_t m_count;
+      size_t m_files;
+      std::deque<std::shared_ptr<Page>> m_pages;
+      // Pages being written, oldest first
+      std::deque<std::shared_future<void>> m_writes;
+      mutable std::mutex m_mutex;
+  };
+
+}
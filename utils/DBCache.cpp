@@ -184,4 +184,62 @@ namespace Utils {
     return std::pair<std::string,std::string>((const char*)key_str,(const char*)value_str);
   }
 
+  void DBCache::clear()
+  {
+    execute_statement("DELETE FROM cache;");
+  }
+
+  void DBCache::begin_transaction()
+  {
+    execute_statement("BEGIN TRANSACTION;");
+  }
+
+  void DBCache::commit_transaction()
+  {
+    execute_statement("COMMIT TRANSACTION;");
+  }
+
+  void DBCache::rollback_transaction()
+  {
+    execute_statement("ROLLBACK TRANSACTION;");
+  }
+
+  DBTransaction::DBTransaction(DBCache* cache)
+    : m_cache(cache),
+      m_open(false)
+  {
+    if (m_cache) {
+      m_cache->begin_transaction();
+      m_open = true;
+    }
+  }
+
+  void DBTransaction::commit()
+  {
+    if (m_open) {
+      m_cache->commit_transaction();
+      m_open = false;
+    }
+  }
+
+  void DBTransaction::checkpoint()
+  {
+    commit();
+    if (m_cache) {
+      m_cache->begin_transaction();
+      m_open = true;
+    }
+  }
+
+  DBTransaction::~DBTransaction()
+  {
+    if (m_open) {
+      // Nothing can be done about a failure while unwinding
+      try {
+        m_cache->rollback_transaction();
+      } catch (const std::exception&) {
+      }
+    }
+  }
+
 }
@@ -19,6 +19,19 @@ namespace Utils {
       // Get first key-value pair found from a set of keys
       std::pair<std::string,std::string> get_any(const std::set<std::string>& keys);
 
+      // Remove every key-value pair
+      void clear();
+
+      // Group the following sets into one transaction
+      // Much faster than committing each set on its own
+      void begin_transaction();
+
+      // Commit the sets made since begin_transaction()
+      void commit_transaction();
+
+      // Throw away the sets made since begin_transaction()
+      void rollback_transaction();
+
       // Virtual destructor
       virtual ~DBCache(); 
     protected:
@@ -35,4 +48,33 @@ namespace Utils {
       sqlite3_stmt* m_multi_select_statement;
       int m_last_multi_select_count;
   };
+
+  /**
+   * A transaction on a DBCache that is rolled back when it goes out of
+   * scope without being committed, so an exception never leaves one open
+   * Does nothing if there is no cache
+   */
+  class DBTransaction {
+    public:
+      // Begin the transaction
+      explicit DBTransaction(DBCache* cache);
+
+      // Commit the sets made so far
+      void commit();
+
+      // Commit the sets made so far and begin a new transaction
+      void checkpoint();
+
+      // Rolls back if not committed
+      ~DBTransaction();
+
+    protected:
+    private:
+      // Not copyable
+      DBTransaction(const DBTransaction&);
+      DBTransaction& operator=(const DBTransaction&);
+
+      DBCache* m_cache;
+      bool m_open;
+  };
 }
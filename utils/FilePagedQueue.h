@@ -1,28 +1,40 @@
 #pragma once
 #include "FilePagedQueue_def.h"
+#include "MappedQueuePage.h"
+#include "ThreadPool.h"
 #include <queue>
-#include <thread>
 #include <string>
 #include <assert.h>
 #include <stdio.h>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
-#include <iomanip>
+#include <stdexcept>
+#include <cstring>
 namespace fs = std::experimental::filesystem;
 
 namespace Utils {
 
+  // Threads shared by every queue to read and write page files
+  inline ThreadPool& page_io_pool()
+  {
+    static ThreadPool pool(page_io_threads);
+    return pool;
+  }
+
   template<class T>
-  FilePagedQueue<T>::FilePagedQueue(std::string directory, std::string prefix, size_t page_size)
+  FilePagedQueue<T>::FilePagedQueue(std::string directory, std::string prefix, size_t page_size,
+    unsigned int read_ahead)
     : m_current_read(0),
       m_last_write(0),
       m_records_paged(0),
       m_dir(directory),
       m_prefix(prefix),
-      m_page_size(page_size)
+      m_page_size(page_size),
+      m_read_ahead(read_ahead)
   {
     assert(page_size > 0);
+    assert(read_ahead > 0);
     assert(!directory.empty());
     assert(!prefix.empty());
     if (!fs::is_directory(directory)) {
@@ -37,12 +49,18 @@ namespace Utils {
   template<class T>
   T& FilePagedQueue<T>::front()
   {
+    if (m_mapped_head) {
+      return m_mapped_head->front();
+    }
     return m_head->front();
   }
 
   template<class T>
   const T& FilePagedQueue<T>::front() const
   {
+    if (m_mapped_head) {
+      return m_mapped_head->front();
+    }
     return m_head->front();
   }
 
@@ -50,33 +68,72 @@ namespace Utils {
   template<class T>
   void FilePagedQueue<T>::pop()
   {
-    m_head->pop();
-    if (m_head->empty()) {
-      // If we are reading a file make sure we have finished
-      sync_reader();
-      
-      // Set the head to the next list if there is one
-      if (m_next) {
-        m_head = m_next;
-        // Kick thread off to load the next queue so hopefully it will
-        // be ready when we need it
-        if (m_current_read < m_last_write) {
-          ++m_current_read;
-          if (m_current_read == m_last_write) {
-            // If reading the last file to be written
-            // make sure it has actually finished!
-            sync_writer();
-          }
-          m_next = std::make_shared<std::queue<T>>();
-          m_reader = std::thread(&FilePagedQueue::unpage,this,m_next);
-        } else if (m_head != m_tail) {
-          // We have caught our own tail
-          m_next = m_tail;
-        } else {
-          // Nowhere left to go
-          m_next = nullptr;
-        }
-      } 
+    if (m_mapped_head) {
+      m_mapped_head->pop();
+      if (m_mapped_head->empty()) {
+        // Unmaps and deletes the page file
+        m_mapped_head.reset();
+      }
+    } else {
+      m_head->pop();
+    }
+    if (empty()) {
+      next_page();
+    }
+  }
+
+  // Move the head on to the next page
+  template<class T>
+  void FilePagedQueue<T>::next_page()
+  {
+    if (m_next) {
+      m_head = m_next;
+      m_next = nullptr;
+    } else if (!m_reads.empty()) {
+      // Wait for the oldest read if it has not finished. It stays
+      // queued if it failed
+      std::shared_ptr<PageRead> read = m_reads.front();
+      read->done.get();
+      m_reads.pop_front();
+      if (read->mapped) {
+        m_records_paged -= read->mapped->size();
+        m_head = std::make_shared<std::queue<T>>();
+        m_mapped_head = std::move(read->mapped);
+      } else {
+        m_records_paged -= read->queue->size();
+        m_head = read->queue;
+      }
+    } else {
+      // Nowhere left to go
+      assert(m_head == m_tail);
+      return;
+    }
+    // Kick off reads of the pages after this one so hopefully they will
+    // be ready when we need them
+    read_ahead();
+    if (m_reads.empty() && m_head != m_tail) {
+      // Nothing left on disk so we have caught our own tail
+      assert(m_current_read == m_last_write);
+      m_next = m_tail;
+    }
+  }
+
+  // Start reading the next pages on disk
+  template<class T>
+  void FilePagedQueue<T>::read_ahead()
+  {
+    while (m_reads.size() < m_read_ahead && m_current_read < m_last_write) {
+      ++m_current_read;
+      // The page may still be being written
+      std::shared_future<void> written;
+      size_t later = (size_t)(m_last_write - m_current_read);
+      if (later < m_writes.size()) {
+        written = m_writes[m_writes.size() - 1 - later];
+      }
+      std::shared_ptr<PageRead> read = std::make_shared<PageRead>();
+      read->done = page_io_pool().submit(std::bind(&FilePagedQueue::unpage,
+        this, read, page_file(m_current_read), written)).share();
+      m_reads.push_back(read);
     }
   }
 
@@ -97,18 +154,29 @@ namespace Utils {
         m_tail = std::make_shared<std::queue<T>>();
       } else {
         // Case 3: Page it out
-        // Finish any existing write
-        sync_writer();
-
         if (m_last_write == m_current_read && m_last_write > 0) {
           // Reset counters, but syncronise first just to be safe!
           syncronize();
-          m_current_read = m_last_write = 0;
+          // Mapped pages delete their own files so must not be reused
+          bool mapped = (bool)m_mapped_head;
+          for (const std::shared_ptr<PageRead>& read : m_reads) {
+            mapped = mapped || read->mapped;
+          }
+          if (!mapped) {
+            m_current_read = m_last_write = 0;
+          }
+        }
+        // Wait for the oldest write if too many are waiting. It stays
+        // queued if it failed
+        if (m_writes.size() >= m_read_ahead) {
+          m_writes.front().get();
+          m_writes.pop_front();
         }
         ++m_last_write;
-        m_writer = std::thread(&FilePagedQueue::page,this,m_tail);
+        // Count the records before the writer starts taking them off
         m_records_paged += m_tail->size();
-        //std::cout << "Records paged: " << m_records_paged << std::endl;
+        m_writes.push_back(page_io_pool().submit(std::bind(&FilePagedQueue::page,
+          this, m_tail, page_file(m_last_write))).share());
         // Start a new tail queue
         m_tail = std::make_shared<std::queue<T>>();
       }
@@ -119,7 +187,8 @@ namespace Utils {
   template<class T>
   bool FilePagedQueue<T>::empty() const
   {
-    return m_head->empty();
+    // A mapped page is let go as soon as it is drained
+    return m_head->empty() && !m_mapped_head;
   }
 
 
@@ -128,15 +197,17 @@ namespace Utils {
   size_t FilePagedQueue<T>::size() const
   {
     size_t count = m_head->size();
+    if (m_mapped_head) {
+      count += m_mapped_head->size();
+    }
     if (m_tail != m_head) {
       count += m_tail->size();
     }
-    if (m_next && m_next != m_tail && !m_reader.joinable())
-    {
+    if (m_next && m_next != m_tail) {
       assert(m_next != m_head);
-      // There is a next queue that is not the tail that is not currently being read
       count += m_next->size();
     }
+    // Includes the pages being read
     count += m_records_paged;
     return count;
   }
@@ -155,12 +226,12 @@ namespace Utils {
       
   // Write the queue to disk
   template<class T>
-  void FilePagedQueue<T>::page(std::shared_ptr<std::queue<T>> queue)
+  void FilePagedQueue<T>::page(std::shared_ptr<std::queue<T>> queue, std::string file)
   {
     assert(!queue->empty());
-    assert(queue->size() == m_page_size);
-    std::string file = page_file(m_last_write);
-    std::ofstream out(file.c_str());
+    // A page is pushed past full if waiting for an earlier write failed
+    assert(queue->size() >= m_page_size);
+    std::ofstream out(file.c_str(), std::ios::binary);
     if (!out.good()) {
       std::string message("Error opening queue file to write: ");
       throw std::runtime_error(message + file);
@@ -169,83 +240,106 @@ namespace Utils {
     out.close();
   }
 
-  // Read the queue from disk
+  // Read a page from disk
   template<class T>
-  void FilePagedQueue<T>::unpage(std::shared_ptr<std::queue<T>> queue)
+  void FilePagedQueue<T>::unpage(std::shared_ptr<PageRead> read, std::string file,
+    std::shared_future<void> written)
   {
-    assert(queue->empty());
-    std::string file = page_file(m_current_read);
-    std::ifstream input(file.c_str());
+    if (written.valid()) {
+      written.get();
+    }
+    if (QueueSerializer<T>::fixed_size > 0) {
+      // Records are decoded from the mapping as they are used
+      read->mapped.reset(new MappedQueuePage<T>(file));
+      assert(read->mapped->size() >= m_page_size);
+      return;
+    }
+    read->queue = std::make_shared<std::queue<T>>();
+    std::ifstream input(file.c_str(), std::ios::binary);
     if (!input.good()) {
       std::string message("Error opening queue file to read: ");
       throw std::runtime_error(message + file);
     }
-    read_from_stream(input,*queue);
+    read_from_stream(input,*read->queue);
     input.close();
-    assert(queue->size() == m_page_size);
+    assert(read->queue->size() >= m_page_size);
     // Page file no longer needed
     remove(file.c_str());
   }
 
+  // Take the pages read ahead and any mapped page into the head and next
+  template<class T>
+  void FilePagedQueue<T>::gather_pages()
+  {
+    syncronize();
+    if (m_mapped_head) {
+      m_mapped_head->drain(*m_head);
+      m_mapped_head.reset();
+    }
+    if (m_reads.empty()) {
+      return;
+    }
+    assert(!m_next);
+    m_next = std::make_shared<std::queue<T>>();
+    while (!m_reads.empty()) {
+      std::shared_ptr<PageRead> read = m_reads.front();
+      read->done.get();
+      if (read->mapped) {
+        m_records_paged -= read->mapped->size();
+        read->mapped->drain(*m_next);
+        // Deletes the page file
+        read->mapped.reset();
+      } else {
+        m_records_paged -= read->queue->size();
+        while (!read->queue->empty()) {
+          m_next->push(std::move(read->queue->front()));
+          read->queue->pop();
+        }
+      }
+      m_reads.pop_front();
+    }
+  }
+
   // Serialise a queue
   template<class T>
   void FilePagedQueue<T>::write_to_stream(std::ostream& os, std::queue<T>& queue) {
-    while (!queue.empty()) {
-      os << queue.front() << std::endl;
-      queue.pop();
-    }
+    // Encode every record first so the block goes out in one write
+    std::string records;
+    QueuePageHeader header;
+    memcpy(header.magic, queue_page_magic, sizeof(queue_page_magic));
+    header.version = page_format_version;
+    header.count = queue.size();
+    QueueSerializer<T>::encode_page(queue, records);
+    header.bytes = records.size();
+    os.write((const char*)&header, sizeof(header));
+    os.write(records.data(), records.size());
   }
 
   // Deserialise a queue
-  // Reads all items or only size items if it is set
   template<class T>
-  void FilePagedQueue<T>::read_from_stream(std::istream& is, std::queue<T>& queue, size_t size)
+  void FilePagedQueue<T>::read_from_stream(std::istream& is, std::queue<T>& queue)
   {
-    T item;
-    int read = 0;
-    while (is >> item)
-    {
-      queue.push(item);
-      if (++read == size) {
-        break;
-      }
+    QueuePageHeader header;
+    if (!is.read((char*)&header, sizeof(header))) {
+      throw std::runtime_error("Invalid queue page header");
     }
-  }
-
-  //----- Specialisation for std::string
-  // Quote spaces and special characters so they can be safely serialised / deserialised
-  template<>
-  void FilePagedQueue<std::string>::write_to_stream(std::ostream& os, std::queue<std::string>& queue) {
-    while (!queue.empty()) {
-      os << std::quoted(queue.front()) << std::endl;
-      queue.pop();
+    check_queue_page_header(header);
+    std::string records((size_t)header.bytes, '\0');
+    if (!is.read(&records[0], records.size())) {
+      throw std::runtime_error("Queue page is cut short");
     }
-  }
-
-  // Read the queue from disk
-  template<>
-  void FilePagedQueue<std::string>::read_from_stream(std::istream& is, std::queue<std::string>& queue, size_t size)
-  {
-    std::string item;
-    int read = 0;
-    while (is >> std::quoted(item))
-    {
-      queue.push(item);
-      if (++read == size) {
-        break;
-      }
+    if (!QueueSerializer<T>::decode_page(records.data(), records.data() + records.size(),
+      header.count, queue)) {
+      throw std::runtime_error("Queue page record is cut short");
     }
   }
-  //------
 
   // Syncronise with reader
   template<class T>
   void FilePagedQueue<T>::sync_reader()
   {
-    if (m_reader.joinable()) {
-      m_reader.join();
-      assert(m_next);
-      m_records_paged -= m_next->size();
+    for (const std::shared_ptr<PageRead>& read : m_reads) {
+      read->done.wait();
     }
   }
 
@@ -253,8 +347,31 @@ namespace Utils {
   template<class T>
   void FilePagedQueue<T>::sync_writer()
   {
-    if (m_writer.joinable()) {
-      m_writer.join();
+    // A write that failed stays queued
+    while (!m_writes.empty()) {
+      m_writes.front().get();
+      m_writes.pop_front();
+    }
+  }
+
+  // Wait for every read and write without throwing
+  template<class T>
+  void FilePagedQueue<T>::finish_io()
+  {
+    for (const std::shared_future<void>& write : m_writes) {
+      try {
+        write.get();
+      } catch (const std::exception& e) {
+        std::cerr << "Error writing queue page: " << e.what() << std::endl;
+      }
+    }
+    m_writes.clear();
+    for (const std::shared_ptr<PageRead>& read : m_reads) {
+      try {
+        read->done.get();
+      } catch (const std::exception& e) {
+        std::cerr << "Error reading queue page: " << e.what() << std::endl;
+      }
     }
   }
 
@@ -268,8 +385,9 @@ namespace Utils {
   template<class T>
   FilePagedQueue<T>::~FilePagedQueue()
   {
-    // Make sure threads finish
-    syncronize();
+    // Make sure the page reads and writes finish. Errors cannot be
+    // thrown from here
+    finish_io();
   }
 
 }
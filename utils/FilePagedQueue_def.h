@@ -1,16 +1,63 @@
 #pragma once
 #include <queue>
-#include <thread>
+#include <deque>
+#include <future>
 #include <string>
 #include <iosfwd>
+#include <memory>
+#include <cstdint>
+#include "QueueSerializer.h"
 
 namespace Utils {
 
+  // Version of the page file format
+  const uint32_t page_format_version = 1;
+
+  // Marks the start of each block of records
+  const char queue_page_magic[4] = {'F','P','Q','\0'};
+
+  // Written in front of each block of records
+  struct QueuePageHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t count;
+    uint64_t bytes;
+  };
+
+  // Number of threads shared by every queue to read and write pages
+  const unsigned int page_io_threads = 4;
+
+  template<class T>
+  class MappedQueuePage;
+
+  /**
+   * Queue that pages to disk once it grows beyond a few pages
+   *
+   * Each page file is a header giving the format version, the number of
+   * records and their size in bytes, followed by the records encoded by
+   * QueueSerializer<T>, all written in one go.
+   *
+   * Pages of fixed size records are read back by mapping the file and
+   * decoding each record from the mapping as it reaches the front.
+   * Other pages are read into a queue in one go.
+   *
+   * Pages are read and written on a pool of threads shared by every
+   * queue. Up to read_ahead pages are read before they are needed, and
+   * up to read_ahead pages can be waiting to be written before push()
+   * waits for the oldest.
+   */
   template<class T>
   class FilePagedQueue {
     public:
-      // Constructor
-      FilePagedQueue(std::string directory, std::string prefix, size_t page_size);
+      /**
+       * Constructor
+       * @param directory Existing directory for the page files
+       * @param prefix Start of the page file names
+       * @param page_size Number of records in each page
+       * @param read_ahead Number of pages read or written in the background
+       */
+      FilePagedQueue(std::string directory, std::string prefix, size_t page_size,
+        unsigned int read_ahead = 1);
 
       // Access the first element
       T& front();
@@ -33,38 +80,63 @@ namespace Utils {
       // But useful for testing
       void syncronize();
 
+      // Serialise a queue as one block with its own header
+      static void write_to_stream(std::ostream& os, std::queue<T>& queue);
+      // Deserialise a block written by write_to_stream
+      static void read_from_stream(std::istream& is, std::queue<T>& queue);
+
       ~FilePagedQueue();
 
     protected:
       // Get the path to the pagefile to use
       std::string page_file(int counter) const;
-      // Serialise a queue
-      void write_to_stream(std::ostream& os, std::queue<T>& queue);
-      // Deserialise a queue
-      // Reads all items or only size items if it is set
-      void read_from_stream(std::istream& is, std::queue<T>& queue, size_t size=0);
+      // Take the pages read ahead and any mapped page into m_head and
+      // m_next so nothing is held outside them
+      void gather_pages();
 
       size_t m_page_size;
       size_t m_records_paged;
+      // Last page file a read was started for
       int m_current_read;
       int m_last_write;
       std::shared_ptr<std::queue<T>> m_head;
+      // Page after the head when it is not on disk. Never set while
+      // pages are being read ahead
       std::shared_ptr<std::queue<T>> m_next;
       std::shared_ptr<std::queue<T>> m_tail;
+      // When set this holds the records of m_head, which is left empty
+      std::unique_ptr<MappedQueuePage<T>> m_mapped_head;
     private:
+      // A page file read in the background
+      struct PageRead {
+        std::shared_ptr<std::queue<T>> queue;
+        std::unique_ptr<MappedQueuePage<T>> mapped;
+        std::shared_future<void> done;
+      };
+
       // Syncronise with reader
       void sync_reader();
       // Syncronise with writer
       void sync_writer();
+      // Wait for every read and write, logging any errors
+      void finish_io();
+      // Start reading the next pages on disk
+      void read_ahead();
+      // Move the head on to the next page
+      void next_page();
       // Write the queue to disk
-      void page(std::shared_ptr<std::queue<T>> queue);
-      // Read the queue from disk
-      void unpage(std::shared_ptr<std::queue<T>> queue);
+      void page(std::shared_ptr<std::queue<T>> queue, std::string file);
+      // Read a page from disk once it has been written
+      void unpage(std::shared_ptr<PageRead> read, std::string file,
+        std::shared_future<void> written);
 
       std::string m_dir;
       std::string m_prefix;
-      std::thread m_reader;
-      std::thread m_writer;
+      unsigned int m_read_ahead;
+      // Pages being read, in order
+      std::deque<std::shared_ptr<PageRead>> m_reads;
+      // Pages being written, up to m_last_write
+      std::deque<std::shared_future<void>> m_writes;
   };
 
 }
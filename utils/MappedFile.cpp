@@ -0,0 +1,105 @@
+#include "MappedFile.h"
+#include <stdexcept>
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace Utils {
+
+#ifdef _WIN32
+
+  MappedFile::MappedFile(const std::string& filename)
+    : m_data(nullptr),
+      m_size(0),
+      m_file(INVALID_HANDLE_VALUE),
+      m_mapping(nullptr)
+  {
+    m_file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+      OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (m_file == INVALID_HANDLE_VALUE) {
+      throw std::runtime_error("Error opening file to map: " + filename);
+    }
+    LARGE_INTEGER size;
+    GetFileSizeEx(m_file, &size);
+    m_size = (size_t)size.QuadPart;
+    if (m_size == 0) {
+      // Empty files cannot be mapped
+      return;
+    }
+    m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (m_mapping) {
+      m_data = (const unsigned char*)MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0);
+    }
+    if (!m_data) {
+      if (m_mapping) {
+        CloseHandle(m_mapping);
+      }
+      CloseHandle(m_file);
+      throw std::runtime_error("Error mapping file: " + filename);
+    }
+  }
+
+  MappedFile::~MappedFile()
+  {
+    if (m_data) {
+      UnmapViewOfFile(m_data);
+    }
+    if (m_mapping) {
+      CloseHandle(m_mapping);
+    }
+    CloseHandle(m_file);
+  }
+
+#else
+
+  MappedFile::MappedFile(const std::string& filename)
+    : m_data(nullptr),
+      m_size(0),
+      m_file(-1)
+  {
+    m_file = open(filename.c_str(), O_RDONLY);
+    if (m_file < 0) {
+      throw std::runtime_error("Error opening file to map: " + filename);
+    }
+    struct stat info;
+    fstat(m_file, &info);
+    m_size = (size_t)info.st_size;
+    if (m_size == 0) {
+      // Empty files cannot be mapped
+      return;
+    }
+    void* data = mmap(nullptr, m_size, PROT_READ, MAP_SHARED, m_file, 0);
+    if (data == MAP_FAILED) {
+      close(m_file);
+      throw std::runtime_error("Error mapping file: " + filename);
+    }
+    m_data = (const unsigned char*)data;
+  }
+
+  MappedFile::~MappedFile()
+  {
+    if (m_data) {
+      munmap((void*)m_data, m_size);
+    }
+    close(m_file);
+  }
+
+#endif
+
+  const unsigned char* MappedFile::data() const
+  {
+    return m_data;
+  }
+
+  size_t MappedFile::size() const
+  {
+    return m_size;
+  }
+}
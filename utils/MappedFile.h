@@ -0,0 +1,45 @@
+#pragma once
+
+#include <string>
+#include <cstddef>
+
+namespace Utils {
+
+  /**
+   * A whole file mapped read only into memory
+   *
+   * The contents are read straight from the page cache with no copy and
+   * only the pages that are touched are loaded.
+   */
+  class MappedFile {
+    public:
+      // Constructor
+      // Throws a std::runtime_error if the file cannot be mapped
+      explicit MappedFile(const std::string& filename);
+
+      // The contents of the file
+      const unsigned char* data() const;
+
+      // Size of the file in bytes
+      size_t size() const;
+
+      // Unmaps the file
+      ~MappedFile();
+
+    protected:
+    private:
+      // Not copyable
+      MappedFile(const MappedFile&);
+      MappedFile& operator=(const MappedFile&);
+
+      const unsigned char* m_data;
+      size_t m_size;
+#ifdef _WIN32
+      void* m_file;
+      void* m_mapping;
+#else
+      int m_file;
+#endif
+  };
+
+}
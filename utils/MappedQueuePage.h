@@ -0,0 +1,169 @@
+#pragma once
+#include <queue>
+#include <string>
+#include <memory>
+#include <stdexcept>
+#include <cstring>
+#include <stdio.h>
+#include "MappedFile.h"
+#include "FilePagedQueue_def.h"
+
+namespace Utils {
+
+  // Check the header of a queue page
+  // Throws a std::runtime_error if it is not one this version can read
+  inline void check_queue_page_header(const QueuePageHeader& header)
+  {
+    if (memcmp(header.magic, queue_page_magic, sizeof(queue_page_magic)) != 0) {
+      throw std::runtime_error("Invalid queue page header");
+    }
+    if (header.version != page_format_version) {
+      throw std::runtime_error("Unsupported queue page version: " + std::to_string(header.version));
+    }
+  }
+
+  /**
+   * A FilePagedQueue page file mapped into memory
+   *
+   * Records are decoded one at a time straight from the mapping as they
+   * reach the front, so the page is never copied into a queue and the
+   * first record can be used as soon as the file is mapped. The file is
+   * unmapped and deleted when the page is destroyed.
+   */
+  template<class T>
+  class MappedQueuePage {
+    public:
+      /**
+       * Constructor
+       * Throws a std::runtime_error if the file is not a valid page
+       * @param filename The page file to map
+       */
+      explicit MappedQueuePage(const std::string& filename);
+
+      // Access the first record
+      T& front();
+      const T& front() const;
+
+      // Remove the first record
+      void pop();
+
+      // Return if every record has been removed
+      bool empty() const;
+
+      // Number of records left
+      size_t size() const;
+
+      // Move the records left onto the end of a queue
+      void drain(std::queue<T>& queue);
+
+      // Unmaps and deletes the page file
+      ~MappedQueuePage();
+
+    protected:
+    private:
+      // Not copyable
+      MappedQueuePage(const MappedQueuePage&);
+      MappedQueuePage& operator=(const MappedQueuePage&);
+
+      // Decode the record at the current position
+      void decode_front();
+
+      std::string m_filename;
+      std::unique_ptr<MappedFile> m_file;
+      const char* m_pos;
+      const char* m_next;
+      const char* m_end;
+      size_t m_remaining;
+      T m_front;
+  };
+
+  template<class T>
+  MappedQueuePage<T>::MappedQueuePage(const std::string& filename)
+    : m_filename(filename),
+      m_file(new MappedFile(filename)),
+      m_pos(nullptr),
+      m_next(nullptr),
+      m_end(nullptr),
+      m_remaining(0)
+  {
+    const char* data = (const char*)m_file->data();
+    QueuePageHeader header;
+    if (m_file->size() < sizeof(header)) {
+      throw std::runtime_error("Invalid queue page header");
+    }
+    memcpy(&header, data, sizeof(header));
+    check_queue_page_header(header);
+    if (m_file->size() - sizeof(header) < header.bytes ||
+      (QueueSerializer<T>::fixed_size > 0 &&
+       header.bytes != header.count * QueueSerializer<T>::fixed_size)) {
+      throw std::runtime_error("Queue page is cut short");
+    }
+    m_pos = data + sizeof(header);
+    m_end = m_pos + header.bytes;
+    m_remaining = (size_t)header.count;
+    if (m_remaining > 0) {
+      decode_front();
+    }
+  }
+
+  template<class T>
+  T& MappedQueuePage<T>::front()
+  {
+    return m_front;
+  }
+
+  template<class T>
+  const T& MappedQueuePage<T>::front() const
+  {
+    return m_front;
+  }
+
+  template<class T>
+  void MappedQueuePage<T>::pop()
+  {
+    --m_remaining;
+    m_pos = m_next;
+    if (m_remaining > 0) {
+      decode_front();
+    }
+  }
+
+  template<class T>
+  bool MappedQueuePage<T>::empty() const
+  {
+    return m_remaining == 0;
+  }
+
+  template<class T>
+  size_t MappedQueuePage<T>::size() const
+  {
+    return m_remaining;
+  }
+
+  template<class T>
+  void MappedQueuePage<T>::drain(std::queue<T>& queue)
+  {
+    while (!empty()) {
+      queue.push(std::move(m_front));
+      pop();
+    }
+  }
+
+  template<class T>
+  void MappedQueuePage<T>::decode_front()
+  {
+    m_next = QueueSerializer<T>::decode(m_pos, m_end, m_front);
+    if (!m_next) {
+      throw std::runtime_error("Queue page record is cut short");
+    }
+  }
+
+  template<class T>
+  MappedQueuePage<T>::~MappedQueuePage()
+  {
+    // Windows will not delete a file that is still mapped
+    m_file.reset();
+    remove(m_filename.c_str());
+  }
+
+}
@@ -2,11 +2,21 @@
 #include "PersistentFilePagedQueue_def.h"
 #include "FilePagedQueue.h"
 #include <stdexcept>
+#include <iostream>
 
 namespace Utils {
+
+  namespace {
+    // How the tail and next queues are stored
+    const char queue_null = 'n';
+    const char queue_shared = 's';
+    const char queue_live = 'l';
+  }
+
   template<class T>
-  PersistentFilePagedQueue<T>::PersistentFilePagedQueue(std::string directory, std::string prefix, size_t page_size)
-    : FilePagedQueue(directory,prefix,page_size)
+  PersistentFilePagedQueue<T>::PersistentFilePagedQueue(std::string directory, std::string prefix, size_t page_size,
+    unsigned int read_ahead)
+    : FilePagedQueue<T>(directory,prefix,page_size,read_ahead)
   {
     restore();
   }
@@ -14,49 +24,54 @@ namespace Utils {
   template<class T>
   PersistentFilePagedQueue<T>::~PersistentFilePagedQueue() 
   {
-    syncronize();
-    store();
+    // Pages read ahead have left disk so are stored with the rest.
+    // Errors cannot be thrown from here
+    try {
+      this->gather_pages();
+      store();
+    } catch (const std::exception& e) {
+      std::cerr << "Error storing queue: " << e.what() << std::endl;
+    }
   }
 
   template<class T>
   void PersistentFilePagedQueue<T>::store()
   {
-    std::string settings_file = page_file(0);
-    std::ofstream out(settings_file.c_str());
+    std::string settings_file = this->page_file(0);
+    std::ofstream out(settings_file.c_str(), std::ios::binary);
     if (!out.good()) {
       std::string message("Error opening settings file to write: ");
       throw std::runtime_error(message + settings_file);
     }
-    std::string space(" ");
-    out << m_page_size << space <<
-      m_records_paged << space <<
-      m_current_read << space <<
-      m_last_write << std::endl;
+    uint64_t settings[4] = {
+      this->m_page_size,
+      this->m_records_paged,
+      (uint64_t)this->m_current_read,
+      (uint64_t)this->m_last_write
+    };
+    out.write((const char*)settings, sizeof(settings));
 
     // Head
-    out << m_head->size() << std::endl;
-    write_to_stream(out,*m_head);
+    this->write_to_stream(out,*this->m_head);
 
     // Tail
-    if (!m_tail) {
-      out << std::string("null") << std::endl;
-    } else if (m_tail == m_head) {
-      out << std::string("head") << std::endl;
+    if (!this->m_tail) {
+      out.put(queue_null);
+    } else if (this->m_tail == this->m_head) {
+      out.put(queue_shared);
     } else {
-      out << std::string("live") << std::endl;
-      out << m_tail->size() << std::endl;
-      write_to_stream(out,*m_tail);
+      out.put(queue_live);
+      this->write_to_stream(out,*this->m_tail);
     }
 
     // Next
-    if (!m_next) {
-      out << std::string("null") << std::endl;
-    } else if (m_next == m_tail) {
-      out << std::string("tail") << std::endl;
+    if (!this->m_next) {
+      out.put(queue_null);
+    } else if (this->m_next == this->m_tail) {
+      out.put(queue_shared);
     } else {
-      out << std::string("live") << std::endl;
-      out << m_next->size() << std::endl;
-      write_to_stream(out,*m_next);
+      out.put(queue_live);
+      this->write_to_stream(out,*this->m_next);
     }
 
     out.close();
@@ -65,44 +80,39 @@ namespace Utils {
   template<class T>
   void PersistentFilePagedQueue<T>::restore()
   {
-    std::string settings_file = page_file(0);
-    std::ifstream in(settings_file.c_str());
+    std::string settings_file = this->page_file(0);
+    std::ifstream in(settings_file.c_str(), std::ios::binary);
     if (!in.good()) {
       return;
     }
 
-    in >> m_page_size;
-    in >> m_records_paged;
-    in >> m_current_read;
-    in >> m_last_write;
+    uint64_t settings[4];
+    if (!in.read((char*)settings, sizeof(settings))) {
+      throw std::runtime_error("Invalid queue settings file: " + settings_file);
+    }
+    this->m_page_size = (size_t)settings[0];
+    this->m_records_paged = (size_t)settings[1];
+    this->m_current_read = (int)settings[2];
+    this->m_last_write = (int)settings[3];
 
-    size_t size;
-    in >> size;
-    read_from_stream(in, *m_head, size);
+    this->read_from_stream(in, *this->m_head);
 
     // Tail
-    std::string status;
-    in >> status;
-    if (status == "head") {
-      m_tail = m_head;
-    } else if (status == "live") {
-      in >> size;
-      m_tail = std::make_shared<std::queue<T>>();
-      if (size > 0) {
-        read_from_stream(in, *m_tail, size);
-      }
+    char status = (char)in.get();
+    if (status == queue_shared) {
+      this->m_tail = this->m_head;
+    } else if (status == queue_live) {
+      this->m_tail = std::make_shared<std::queue<T>>();
+      this->read_from_stream(in, *this->m_tail);
     }
 
     // Next
-    in >> status;
-    if (status == "tail") {
-      m_next = m_tail;
-    } else if (status == "live") {
-      in >> size;
-      m_next = std::make_shared<std::queue<T>>();
-      if (size > 0) {
-        read_from_stream(in, *m_next, size);
-      }
+    status = (char)in.get();
+    if (status == queue_shared) {
+      this->m_next = this->m_tail;
+    } else if (status == queue_live) {
+      this->m_next = std::make_shared<std::queue<T>>();
+      this->read_from_stream(in, *this->m_next);
     }
     in.close();
     // Settings file no longer needed
@@ -8,7 +8,8 @@ namespace Utils {
   {
     public:
       // Constructor
-      PersistentFilePagedQueue(std::string directory, std::string prefix, size_t page_size);
+      PersistentFilePagedQueue(std::string directory, std::string prefix, size_t page_size,
+        unsigned int read_ahead = 1);
       ~PersistentFilePagedQueue();
     protected:
     private:
@@ -0,0 +1,187 @@
+#pragma once
+#include <string>
+#include <queue>
+#include <sstream>
+#include <cstring>
+#include <cstdint>
+#include <type_traits>
+
+namespace Utils {
+
+  // Append a block of bytes preceded by its length
+  inline void encode_length_prefixed(const char* data, size_t size, std::string& out)
+  {
+    uint32_t length = (uint32_t)size;
+    out.append((const char*)&length, sizeof(length));
+    out.append(data, size);
+  }
+
+  // Read a block of bytes preceded by its length
+  // Returns the position after it or nullptr if the block is cut short
+  inline const char* decode_length_prefixed(const char* begin, const char* end, std::string& data)
+  {
+    uint32_t length;
+    if ((size_t)(end - begin) < sizeof(length)) {
+      return nullptr;
+    }
+    memcpy(&length, begin, sizeof(length));
+    begin += sizeof(length);
+    if ((size_t)(end - begin) < length) {
+      return nullptr;
+    }
+    data.assign(begin, length);
+    return begin + length;
+  }
+
+  /**
+   * Encoding of whole pages for a QueueSerializer
+   *
+   * Serializers derive from this, passing themselves as the second
+   * parameter, to get page encoding and decoding built from their
+   * encode() and decode(). A serializer can hide these with its own to
+   * handle a page at once.
+   */
+  template<class T, class Serializer>
+  struct QueuePageSerializer {
+    // Append the encoding of every item of a queue, emptying it
+    static void encode_page(std::queue<T>& queue, std::string& out)
+    {
+      if (Serializer::fixed_size > 0) {
+        out.reserve(out.size() + queue.size() * Serializer::fixed_size);
+      }
+      while (!queue.empty()) {
+        Serializer::encode(queue.front(), out);
+        queue.pop();
+      }
+    }
+
+    // Decode a number of items onto a queue
+    // Returns false if the page is cut short
+    static bool decode_page(const char* begin, const char* end, uint64_t count,
+      std::queue<T>& queue)
+    {
+      if (Serializer::fixed_size > 0 && (uint64_t)(end - begin) < count * Serializer::fixed_size) {
+        return false;
+      }
+      for (uint64_t i=0;i<count;++i) {
+        T item;
+        begin = Serializer::decode(begin, end, item);
+        if (!begin) {
+          return false;
+        }
+        queue.push(std::move(item));
+      }
+      return true;
+    }
+  };
+
+  // Whether a type says how it is queued with a nested QueueEncoding
+  template<class T, class Enable = void>
+  struct has_queue_encoding : std::false_type {};
+
+  template<class T>
+  struct has_queue_encoding<T,
+    typename std::conditional<true, void, typename T::QueueEncoding>::type> : std::true_type {};
+
+  /**
+   * How the elements of a FilePagedQueue are written to its page files
+   *
+   * A type can give its own encoding with a nested QueueEncoding having
+   * fixed_size, encode() and decode() as below. Being part of the type
+   * it is used wherever the type is queued. Otherwise specialise this
+   * for the type, visible everywhere it is queued. A serializer has
+   *   fixed_size - bytes in every record, or 0 if records vary in size.
+   *                An enumerator so it needs no definition anywhere
+   *   encode()   - append the encoding of an item to a string
+   *   decode()   - decode an item, returning the position after it or
+   *                nullptr if the record is cut short
+   * plus encode_page() and decode_page(), usually by deriving from
+   * QueuePageSerializer. With a fixed size a page can be checked for
+   * length up front and records can be found without decoding those
+   * before them.
+   *
+   * By default an element is written as the text from operator<< with
+   * its length in front, and read back with operator>>. Trivially
+   * copyable types with no QueueEncoding are written as their bytes and
+   * strings with their length in front.
+   */
+  template<class T, class Enable = void>
+  struct QueueSerializer : QueuePageSerializer<T, QueueSerializer<T,Enable>> {
+    enum : size_t { fixed_size = 0 };
+
+    static void encode(const T& item, std::string& out)
+    {
+      std::ostringstream text;
+      text << item;
+      std::string str = text.str();
+      encode_length_prefixed(str.data(), str.size(), out);
+    }
+
+    static const char* decode(const char* begin, const char* end, T& item)
+    {
+      std::string str;
+      const char* next = decode_length_prefixed(begin, end, str);
+      if (next) {
+        std::istringstream text(str);
+        text >> item;
+      }
+      return next;
+    }
+  };
+
+  // Types with a QueueEncoding are written by it
+  template<class T>
+  struct QueueSerializer<T, typename std::enable_if<has_queue_encoding<T>::value>::type>
+    : QueuePageSerializer<T, QueueSerializer<T>> {
+    enum : size_t { fixed_size = T::QueueEncoding::fixed_size };
+
+    static void encode(const T& item, std::string& out)
+    {
+      T::QueueEncoding::encode(item, out);
+    }
+
+    static const char* decode(const char* begin, const char* end, T& item)
+    {
+      return T::QueueEncoding::decode(begin, end, item);
+    }
+  };
+
+  // Other trivially copyable types are written as their bytes
+  template<class T>
+  struct QueueSerializer<T, typename std::enable_if<std::is_trivially_copyable<T>::value &&
+    !has_queue_encoding<T>::value>::type>
+    : QueuePageSerializer<T, QueueSerializer<T>> {
+    enum : size_t { fixed_size = sizeof(T) };
+
+    static void encode(const T& item, std::string& out)
+    {
+      out.append((const char*)&item, sizeof(T));
+    }
+
+    static const char* decode(const char* begin, const char* end, T& item)
+    {
+      if ((size_t)(end - begin) < sizeof(T)) {
+        return nullptr;
+      }
+      memcpy(&item, begin, sizeof(T));
+      return begin + sizeof(T);
+    }
+  };
+
+  // Strings are written with their length in front so can hold anything
+  template<>
+  struct QueueSerializer<std::string> : QueuePageSerializer<std::string, QueueSerializer<std::string>> {
+    enum : size_t { fixed_size = 0 };
+
+    static void encode(const std::string& item, std::string& out)
+    {
+      encode_length_prefixed(item.data(), item.size(), out);
+    }
+
+    static const char* decode(const char* begin, const char* end, std::string& item)
+    {
+      return decode_length_prefixed(begin, end, item);
+    }
+  };
+
+}
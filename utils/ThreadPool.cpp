@@ -0,0 +1,59 @@
+#include "ThreadPool.h"
+#include <algorithm>
+
+namespace Utils {
+
+  // Constructor
+  ThreadPool::ThreadPool(unsigned int threads)
+    : m_stopping(false)
+  {
+    if (threads == 0) {
+      threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    for (unsigned int i=0;i<threads;++i) {
+      m_threads.emplace_back(&ThreadPool::run, this);
+    }
+  }
+
+  // Take tasks off the queue
+  void ThreadPool::run()
+  {
+    while (true) {
+      std::function<void()> task;
+      {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_ready.wait(lock, [this]() { return m_stopping || !m_tasks.empty(); });
+        if (m_tasks.empty()) {
+          return;
+        }
+        task = std::move(m_tasks.front());
+        m_tasks.pop_front();
+      }
+      task();
+    }
+  }
+
+  unsigned int ThreadPool::size() const
+  {
+    return (unsigned int)m_threads.size();
+  }
+
+  size_t ThreadPool::queued()
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_tasks.size();
+  }
+
+  // Destructor
+  ThreadPool::~ThreadPool()
+  {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_stopping = true;
+    }
+    m_ready.notify_all();
+    for (std::thread& thread : m_threads) {
+      thread.join();
+    }
+  }
+}
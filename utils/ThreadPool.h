@@ -0,0 +1,80 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <type_traits>
+
+namespace Utils {
+
+  /**
+   * A fixed set of worker threads taking tasks from one queue
+   *
+   * Tasks run in the order they are submitted, as threads come free.
+   * The destructor waits for every task already submitted to finish.
+   */
+  class ThreadPool {
+    public:
+      /**
+       * Constructor
+       * @param threads Number of worker threads. 0 uses one per core
+       */
+      explicit ThreadPool(unsigned int threads = 0);
+
+      /**
+       * Queue a task to run on a worker thread
+       * Any exception the task throws is passed on by the future
+       * @param task Callable taking no arguments
+       * @return Future for the value the task returns
+       */
+      template<typename F>
+      std::future<typename std::result_of<F()>::type> submit(F task);
+
+      // Number of worker threads
+      unsigned int size() const;
+
+      // Number of tasks waiting for a thread
+      size_t queued();
+
+      // Finishes the queued tasks then stops the threads
+      ~ThreadPool();
+
+    protected:
+    private:
+      // Not copyable
+      ThreadPool(const ThreadPool&);
+      ThreadPool& operator=(const ThreadPool&);
+
+      // Run tasks until stopped
+      void run();
+
+      std::vector<std::thread> m_threads;
+      std::deque<std::function<void()>> m_tasks;
+      std::mutex m_mutex;
+      std::condition_variable m_ready;
+      bool m_stopping;
+  };
+
+  // Queue a task
+  template<typename F>
+  std::future<typename std::result_of<F()>::type> ThreadPool::submit(F task)
+  {
+    typedef typename std::result_of<F()>::type Result;
+    // packaged_task cannot be copied so is shared with the queued function
+    std::shared_ptr<std::packaged_task<Result()>> packaged =
+      std::make_shared<std::packaged_task<Result()>>(std::move(task));
+    std::future<Result> result = packaged->get_future();
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_tasks.push_back([packaged]() { (*packaged)(); });
+    }
+    m_ready.notify_one();
+    return result;
+  }
+
+}
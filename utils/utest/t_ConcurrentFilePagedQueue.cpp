@@ -0,0 +1,194 @@
+#include <gtest/gtest.h>
+#include "ConcurrentFilePagedQueue.h"
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <filesystem>
+namespace fs = std::experimental::filesystem;
+
+#define MKDIR(dirname) \
+  fs::create_directory(dirname)
+
+#define RMDIR(directory) \
+  fs::remove_all(directory)
+
+TEST(ConcurrentFilePagedQueueTest,staging)
+{
+  std::string dir = "t_ConcurrentFilePagedQueue_01";
+  RMDIR(dir);
+  MKDIR(dir);
+  {
+    Utils::ConcurrentFilePagedQueue<int> q(dir,"queue",3);
+    Utils::ConcurrentFilePagedQueue<int>::Consumer consumer(q);
+    int value;
+    {
+      Utils::ConcurrentFilePagedQueue<int>::Producer producer(q);
+      producer.push(0);
+      producer.push(1);
+      // Nothing is added until a page is staged
+      EXPECT_TRUE(q.empty());
+      EXPECT_FALSE(consumer.pop(value));
+      producer.push(2);
+      EXPECT_EQ(q.size(), 3u);
+      producer.push(3);
+      producer.flush();
+      EXPECT_EQ(q.size(), 4u);
+      producer.push(4);
+    }
+    // Destroying the producer flushes it
+    EXPECT_EQ(q.size(), 5u);
+    // A page is taken at a time
+    ASSERT_TRUE(consumer.pop(value));
+    EXPECT_EQ(value, 0);
+    EXPECT_EQ(consumer.taken(), 2u);
+    EXPECT_EQ(q.size(), 2u);
+    for (int i=1;i<5;++i) {
+      ASSERT_TRUE(consumer.pop(value));
+      EXPECT_EQ(value, i);
+    }
+    EXPECT_FALSE(consumer.pop(value));
+    EXPECT_TRUE(q.empty());
+  }
+  RMDIR(dir);
+}
+
+TEST(ConcurrentFilePagedQueueTest,pagesOnDisk)
+{
+  // Pages beyond the first read_ahead + 1 are written out
+  std::string dir = "t_ConcurrentFilePagedQueue_04";
+  RMDIR(dir);
+  MKDIR(dir);
+  {
+    Utils::ConcurrentFilePagedQueue<int> q(dir,"queue",2,1);
+    {
+      Utils::ConcurrentFilePagedQueue<int>::Producer producer(q);
+      for (int i=0;i<10;++i) {
+        producer.push(i);
+      }
+    }
+    q.syncronize();
+    EXPECT_EQ(q.size(), 10u);
+    for (int n=1;n<=3;++n) {
+      EXPECT_TRUE(fs::exists(fs::path(dir) / ("queue" + std::to_string(n) + ".q")));
+    }
+    Utils::ConcurrentFilePagedQueue<int>::Consumer consumer(q);
+    int value;
+    for (int i=0;i<10;++i) {
+      ASSERT_TRUE(consumer.pop(value));
+      EXPECT_EQ(value, i);
+    }
+    EXPECT_FALSE(consumer.pop(value));
+    q.syncronize();
+    for (int n=1;n<=3;++n) {
+      EXPECT_FALSE(fs::exists(fs::path(dir) / ("queue" + std::to_string(n) + ".q")));
+    }
+  }
+  RMDIR(dir);
+}
+
+TEST(ConcurrentFilePagedQueueTest,producersThenConsumers)
+{
+  std::string dir = "t_ConcurrentFilePagedQueue_02";
+  RMDIR(dir);
+  MKDIR(dir);
+  {
+    const int threads = 4;
+    const int per_thread = 5000;
+    Utils::ConcurrentFilePagedQueue<int> q(dir,"queue",100,2);
+    std::vector<std::thread> workers;
+    for (int t=0;t<threads;++t) {
+      workers.emplace_back([&q, t]() {
+        Utils::ConcurrentFilePagedQueue<int>::Producer producer(q);
+        for (int i=0;i<per_thread;++i) {
+          producer.push(t * per_thread + i);
+        }
+      });
+    }
+    for (std::thread& worker : workers) {
+      worker.join();
+    }
+    EXPECT_EQ(q.size(), (size_t)(threads * per_thread));
+
+    // Every record comes out once, in order from each producer
+    std::vector<std::vector<int>> popped(threads);
+    workers.clear();
+    for (int t=0;t<threads;++t) {
+      workers.emplace_back([&q, &popped, t]() {
+        Utils::ConcurrentFilePagedQueue<int>::Consumer consumer(q);
+        int value;
+        while (consumer.pop(value)) {
+          popped[t].push_back(value);
+        }
+      });
+    }
+    for (std::thread& worker : workers) {
+      worker.join();
+    }
+    std::vector<int> seen(threads * per_thread, 0);
+    for (const std::vector<int>& values : popped) {
+      std::vector<int> last(threads, -1);
+      for (int value : values) {
+        ++seen[value];
+        int producer = value / per_thread;
+        EXPECT_GT(value, last[producer]);
+        last[producer] = value;
+      }
+    }
+    for (int count : seen) {
+      ASSERT_EQ(count, 1);
+    }
+    EXPECT_TRUE(q.empty());
+  }
+  RMDIR(dir);
+}
+
+TEST(ConcurrentFilePagedQueueTest,together)
+{
+  // Producers and consumers running at the same time
+  std::string dir = "t_ConcurrentFilePagedQueue_03";
+  RMDIR(dir);
+  MKDIR(dir);
+  {
+    const int threads = 3;
+    const int per_thread = 20000;
+    Utils::ConcurrentFilePagedQueue<std::string> q(dir,"queue",50,2);
+    std::atomic<int> producing(threads);
+    std::atomic<long long> total(0);
+    std::atomic<int> count(0);
+    std::vector<std::thread> workers;
+    for (int t=0;t<threads;++t) {
+      workers.emplace_back([&q, &producing, t]() {
+        Utils::ConcurrentFilePagedQueue<std::string>::Producer producer(q);
+        for (int i=0;i<per_thread;++i) {
+          producer.push(std::to_string(t * per_thread + i));
+        }
+        producer.flush();
+        --producing;
+      });
+      workers.emplace_back([&q, &producing, &total, &count]() {
+        Utils::ConcurrentFilePagedQueue<std::string>::Consumer consumer(q);
+        std::string value;
+        while (true) {
+          bool finished = producing == 0;
+          if (consumer.pop(value)) {
+            total += std::stoi(value);
+            ++count;
+          } else if (finished) {
+            break;
+          } else {
+            std::this_thread::yield();
+          }
+        }
+      });
+    }
+    for (std::thread& worker : workers) {
+      worker.join();
+    }
+    long long n = threads * per_thread;
+    EXPECT_EQ(count, n);
+    EXPECT_EQ(total, n * (n - 1) / 2);
+    EXPECT_TRUE(q.empty());
+  }
+  RMDIR(dir);
+}
@@ -2,6 +2,7 @@
 #include "DBCache.h"
 #include <sys/stat.h>
 #include <stdio.h>
+#include <stdexcept>
 
 static bool exists(std::string filename)
 {
@@ -116,3 +117,63 @@ TEST(DBCacheTest,get_any)
   DELETE_IF_EXISTS(file);
 
 }
+
+TEST(DBCacheTest,transaction)
+{
+  std::string file = "./t_dbcache_04.db";
+  DELETE_IF_EXISTS(file);
+  EXPECT_NOT_EXISTS(file);
+
+  {
+    Utils::DBCache cache(file);
+
+    cache.begin_transaction();
+    for (int i=0;i<1000;++i) {
+      cache.set("key" + std::to_string(i), std::to_string(i * i));
+    }
+    // Sets can be read back before they are committed
+    EXPECT_EQ(cache.get("key10"), "100");
+    cache.commit_transaction();
+    EXPECT_EQ(cache.get("key999"), "998001");
+  }
+  {
+    // and they are still there after reopening
+    Utils::DBCache cache(file);
+    EXPECT_EQ(cache.get("key20"), "400");
+  }
+  DELETE_IF_EXISTS(file);
+}
+
+TEST(DBCacheTest,rollback)
+{
+  std::string file = "./t_dbcache_05.db";
+  DELETE_IF_EXISTS(file);
+
+  {
+    Utils::DBCache cache(file);
+    {
+      Utils::DBTransaction transaction(&cache);
+      cache.set("kept", "1");
+      transaction.checkpoint();
+      cache.set("lost", "2");
+      // Not committed so rolled back here
+    }
+    EXPECT_EQ(cache.get("kept"), "1");
+    EXPECT_EQ(cache.get("lost"), "");
+    try {
+      Utils::DBTransaction transaction(&cache);
+      cache.set("thrown", "3");
+      throw std::runtime_error("error");
+    } catch (const std::runtime_error&) {
+    }
+    EXPECT_EQ(cache.get("thrown"), "");
+    // A new transaction can be started after a rollback
+    {
+      Utils::DBTransaction transaction(&cache);
+      cache.set("committed", "4");
+      transaction.commit();
+    }
+    EXPECT_EQ(cache.get("committed"), "4");
+  }
+  DELETE_IF_EXISTS(file);
+}
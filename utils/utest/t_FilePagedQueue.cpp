@@ -6,6 +6,9 @@
 #include <filesystem>
 #include <stdlib.h>
 #include <time.h>
+#include <fstream>
+#include <cstring>
+#include <vector>
 namespace fs = std::experimental::filesystem;
 
 
@@ -106,9 +109,10 @@ TEST(FilePagedQueueTest,paging)
   RMDIR(dir);
   MKDIR(dir);
   {
-    Utils::FilePagedQueue<int> q(dir,"queue",3);
+    // Strings are read back in one go so page files go as soon as they load
+    Utils::FilePagedQueue<std::string> q(dir,"queue",3);
     // If we push 9 items the first page file should appear
-    REPEAT(9,q.push(0));
+    REPEAT(9,q.push("0"));
     q.syncronize();
     EXPECT_EXISTS("t_FilePagedQueue_04\\queue1.q");
     // Read three and it should disappear again
@@ -116,11 +120,11 @@ TEST(FilePagedQueueTest,paging)
     q.syncronize();
     EXPECT_NOT_EXISTS("t_FilePagedQueue_04\\queue1.q");
     // Push three and it should come back
-    REPEAT(3,q.push(0));
+    REPEAT(3,q.push("0"));
     q.syncronize();
     EXPECT_EXISTS("t_FilePagedQueue_04\\queue1.q");
     // Push another three and second page file should appear
-    REPEAT(3,q.push(0));
+    REPEAT(3,q.push("0"));
     q.syncronize();
     EXPECT_EXISTS("t_FilePagedQueue_04\\queue1.q");
     EXPECT_EXISTS("t_FilePagedQueue_04\\queue2.q");
@@ -130,7 +134,7 @@ TEST(FilePagedQueueTest,paging)
     EXPECT_NOT_EXISTS("t_FilePagedQueue_04\\queue1.q");
     EXPECT_EXISTS("t_FilePagedQueue_04\\queue2.q");
     // Push another 3 now and third file should appear but still not first
-    REPEAT(3,q.push(0));
+    REPEAT(3,q.push("0"));
     q.syncronize();
     EXPECT_NOT_EXISTS("t_FilePagedQueue_04\\queue1.q");
     EXPECT_EXISTS("t_FilePagedQueue_04\\queue2.q");
@@ -148,7 +152,7 @@ TEST(FilePagedQueueTest,paging)
     EXPECT_NOT_EXISTS("t_FilePagedQueue_04\\queue2.q");
     EXPECT_NOT_EXISTS("t_FilePagedQueue_04\\queue3.q");
     // Push three now and counter should reset to one
-    REPEAT(3,q.push(0));
+    REPEAT(3,q.push("0"));
     q.syncronize();
     EXPECT_EXISTS("t_FilePagedQueue_04\\queue1.q");
   }
@@ -179,3 +183,216 @@ TEST(FilePagedQueueTest,randomExercise)
   }
   RMDIR(dir);
 }
+
+namespace {
+  struct Record {
+    int id;
+    double value;
+    char tag[5];
+  };
+}
+
+TEST(FilePagedQueueTest,binaryRecords)
+{
+  std::string dir = "t_FilePagedQueue_06";
+  RMDIR(dir);
+  MKDIR(dir);
+  {
+    Utils::FilePagedQueue<Record> q(dir,"queue",3);
+    for (int i=0;i<20;++i) {
+      Record r = {i, i * 0.5, "abcd"};
+      r.tag[0] = (char)i;
+      q.push(r);
+    }
+    q.syncronize();
+    // Page files start with the header
+    std::ifstream page((fs::path(dir) / "queue1.q").string().c_str(), std::ios::binary);
+    Utils::QueuePageHeader header;
+    ASSERT_TRUE(page.read((char*)&header, sizeof(header)).good());
+    EXPECT_EQ(memcmp(header.magic, Utils::queue_page_magic, 4), 0);
+    EXPECT_EQ(header.version, Utils::page_format_version);
+    EXPECT_EQ(header.count, 3u);
+    EXPECT_EQ(header.bytes, 3 * sizeof(Record));
+    page.close();
+    for (int i=0;i<20;++i) {
+      ASSERT_EQ(q.front().id, i);
+      EXPECT_EQ(q.front().value, i * 0.5);
+      EXPECT_EQ(q.front().tag[0], (char)i);
+      EXPECT_EQ(std::string(q.front().tag + 1), "bcd");
+      q.pop();
+    }
+    EXPECT_TRUE(q.empty());
+  }
+  RMDIR(dir);
+}
+
+TEST(FilePagedQueueTest,binaryStrings)
+{
+  // Strings come back exactly, whatever they hold
+  std::string dir = "t_FilePagedQueue_07";
+  RMDIR(dir);
+  MKDIR(dir);
+  {
+    std::vector<std::string> items = {"", "two words", "line\nbreak", "\"quoted\"",
+      std::string("nul\0byte", 8), " ", "\t", "last"};
+    Utils::FilePagedQueue<std::string> q(dir,"queue",2);
+    for (int n=0;n<3;++n) {
+      for (const std::string& item : items) {
+        q.push(item);
+      }
+    }
+    for (int n=0;n<3;++n) {
+      for (const std::string& item : items) {
+        ASSERT_EQ(q.front(), item);
+        q.pop();
+      }
+    }
+    EXPECT_TRUE(q.empty());
+  }
+  RMDIR(dir);
+}
+
+TEST(FilePagedQueueTest,mappedPaging)
+{
+  // Pages of fixed size records are mapped, so each page file stays
+  // until the last of its records is popped
+  std::string dir = "t_FilePagedQueue_08";
+  RMDIR(dir);
+  MKDIR(dir);
+  {
+    std::string page1 = (fs::path(dir) / "queue1.q").string();
+    std::string page2 = (fs::path(dir) / "queue2.q").string();
+    Utils::FilePagedQueue<int> q(dir,"queue",3);
+    int next = 0;
+    auto pop_three = [&]() {
+      for (int i=0;i<3;++i) {
+        ASSERT_EQ(q.front(), next++);
+        q.pop();
+      }
+      q.syncronize();
+    };
+    for (int i=0;i<9;++i) {
+      q.push(i);
+    }
+    q.syncronize();
+    EXPECT_EXISTS(page1);
+    // First page is mapped ready to read
+    pop_three();
+    EXPECT_EXISTS(page1);
+    EXPECT_EQ(q.size(), 6u);
+    // A new page must not reuse the file of a mapped one
+    for (int i=9;i<12;++i) {
+      q.push(i);
+    }
+    q.syncronize();
+    EXPECT_EXISTS(page2);
+    EXPECT_EQ(q.size(), 9u);
+    // Reading from the first page, second is mapped ready
+    pop_three();
+    EXPECT_EXISTS(page1);
+    EXPECT_EXISTS(page2);
+    // First page drained
+    pop_three();
+    EXPECT_NOT_EXISTS(page1);
+    EXPECT_EXISTS(page2);
+    EXPECT_EQ(q.size(), 3u);
+    pop_three();
+    EXPECT_NOT_EXISTS(page2);
+    EXPECT_TRUE(q.empty());
+    EXPECT_EQ(q.size(), 0u);
+  }
+  RMDIR(dir);
+}
+
+TEST(FilePagedQueueTest,readAhead)
+{
+  // Several pages are read before they are needed
+  std::string dir = "t_FilePagedQueue_09";
+  RMDIR(dir);
+  MKDIR(dir);
+  {
+    Utils::FilePagedQueue<std::string> q(dir,"queue",2,3);
+    for (int i=0;i<12;++i) {
+      q.push(std::to_string(i));
+    }
+    q.syncronize();
+    for (int n=1;n<=4;++n) {
+      EXPECT_EXISTS((fs::path(dir) / ("queue" + std::to_string(n) + ".q")).string());
+    }
+    // Moving on to the second page starts reading the next three
+    q.pop();
+    q.pop();
+    q.syncronize();
+    for (int n=1;n<=3;++n) {
+      EXPECT_NOT_EXISTS((fs::path(dir) / ("queue" + std::to_string(n) + ".q")).string());
+    }
+    EXPECT_EXISTS((fs::path(dir) / "queue4.q").string());
+    EXPECT_EQ(q.size(), 10u);
+    for (int i=2;i<12;++i) {
+      ASSERT_EQ(q.front(), std::to_string(i));
+      q.pop();
+    }
+    EXPECT_TRUE(q.empty());
+    EXPECT_NOT_EXISTS((fs::path(dir) / "queue4.q").string());
+  }
+  RMDIR(dir);
+}
+
+TEST(FilePagedQueueTest,readAheadExercise)
+{
+  // Bursts of pushes and pops with several pages in flight each way
+  srand ((unsigned int)time(NULL));
+  std::string dir = "t_FilePagedQueue_10";
+  RMDIR(dir);
+  MKDIR(dir);
+  {
+    Utils::FilePagedQueue<int> mapped(dir,"mapped",3,4);
+    Utils::FilePagedQueue<std::string> strings(dir,"strings",3,4);
+    std::queue<int> reference;
+    int counter = 0;
+    for (int burst=0;burst<100;++burst) {
+      int count = rand() % 40;
+      bool pushing = reference.empty() || (rand() % 2) > 0;
+      for (int i=0;i<count;++i) {
+        if (pushing) {
+          mapped.push(counter);
+          strings.push(std::to_string(counter));
+          reference.push(counter++);
+        } else if (!reference.empty()) {
+          ASSERT_EQ(mapped.size(),reference.size());
+          ASSERT_EQ(strings.size(),reference.size());
+          ASSERT_EQ(mapped.front(),reference.front());
+          ASSERT_EQ(strings.front(),std::to_string(reference.front()));
+          mapped.pop();
+          strings.pop();
+          reference.pop();
+        }
+      }
+    }
+    EXPECT_EQ(mapped.empty(), reference.empty());
+    EXPECT_EQ(strings.empty(), reference.empty());
+  }
+  RMDIR(dir);
+}
+
+TEST(FilePagedQueueTest,writeError)
+{
+  // A failed write is thrown by a later push, and not from the destructor
+  std::string dir = "t_FilePagedQueue_11";
+  RMDIR(dir);
+  MKDIR(dir);
+  {
+    Utils::FilePagedQueue<int> q(dir,"queue",2);
+    RMDIR(dir);
+    bool thrown = false;
+    try {
+      for (int i=0;i<10;++i) {
+        q.push(i);
+      }
+    } catch (const std::runtime_error&) {
+      thrown = true;
+    }
+    EXPECT_TRUE(thrown);
+  }
+  RMDIR(dir);
+}
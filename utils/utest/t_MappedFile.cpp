@@ -0,0 +1,43 @@
+#include <gtest/gtest.h>
+#include "MappedFile.h"
+#include <string>
+#include <fstream>
+#include <stdexcept>
+#include <stdio.h>
+
+TEST(MappedFileTest,read)
+{
+  std::string file = "./t_mappedfile_01.bin";
+  std::string contents;
+  for (int i=0;i<10000;++i) {
+    contents += (char)(i * 7);
+  }
+  {
+    std::ofstream out(file.c_str(), std::ios::binary);
+    out.write(contents.data(), contents.size());
+  }
+  {
+    Utils::MappedFile mapped(file);
+    ASSERT_EQ(mapped.size(), contents.size());
+    EXPECT_EQ(std::string((const char*)mapped.data(), mapped.size()), contents);
+  }
+  remove(file.c_str());
+}
+
+TEST(MappedFileTest,empty)
+{
+  std::string file = "./t_mappedfile_02.bin";
+  {
+    std::ofstream out(file.c_str(), std::ios::binary);
+  }
+  {
+    Utils::MappedFile mapped(file);
+    EXPECT_EQ(mapped.size(), 0u);
+  }
+  remove(file.c_str());
+}
+
+TEST(MappedFileTest,missing)
+{
+  EXPECT_THROW(Utils::MappedFile("./t_mappedfile_missing.bin"), std::runtime_error);
+}
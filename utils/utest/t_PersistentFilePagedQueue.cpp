@@ -124,36 +124,37 @@ TEST(PersistentFilePagedQueueTest,paging)
   RMDIR(dir);
   MKDIR(dir);
   {
-    Utils::PersistentFilePagedQueue<int> q(dir,"queue",3);
+    // Strings are read back in one go so page files go as soon as they load
+    Utils::PersistentFilePagedQueue<std::string> q(dir,"queue",3);
     // If we push 9 items the first page file should appear
-    REPEAT(9,q.push(0));
+    REPEAT(9,q.push("0"));
     q.syncronize();
     EXPECT_EXISTS("t_PersistentFilePagedQueue_04\\queue1.q");
   }
   {
-    Utils::PersistentFilePagedQueue<int> q(dir,"queue",3);
+    Utils::PersistentFilePagedQueue<std::string> q(dir,"queue",3);
     // Read three and it should disappear again
     REPEAT(3,q.pop());
     q.syncronize();
     EXPECT_NOT_EXISTS("t_PersistentFilePagedQueue_04\\queue1.q");
   }
   {
-    Utils::PersistentFilePagedQueue<int> q(dir,"queue",3);
+    Utils::PersistentFilePagedQueue<std::string> q(dir,"queue",3);
     // Push three and it should come back
-    REPEAT(3,q.push(0));
+    REPEAT(3,q.push("0"));
     q.syncronize();
     EXPECT_EXISTS("t_PersistentFilePagedQueue_04\\queue1.q");
   }
   {
-    Utils::PersistentFilePagedQueue<int> q(dir,"queue",3);
+    Utils::PersistentFilePagedQueue<std::string> q(dir,"queue",3);
     // Push another three and second page file should appear
-    REPEAT(3,q.push(0));
+    REPEAT(3,q.push("0"));
     q.syncronize();
     EXPECT_EXISTS("t_PersistentFilePagedQueue_04\\queue1.q");
     EXPECT_EXISTS("t_PersistentFilePagedQueue_04\\queue2.q");
   }
   {
-    Utils::PersistentFilePagedQueue<int> q(dir,"queue",3);
+    Utils::PersistentFilePagedQueue<std::string> q(dir,"queue",3);
     // Pop three and first page file should go but second remain
     REPEAT(3,q.pop());
     q.syncronize();
@@ -161,16 +162,16 @@ TEST(PersistentFilePagedQueueTest,paging)
     EXPECT_EXISTS("t_PersistentFilePagedQueue_04\\queue2.q");
   }
   {
-    Utils::PersistentFilePagedQueue<int> q(dir,"queue",3);
+    Utils::PersistentFilePagedQueue<std::string> q(dir,"queue",3);
     // Push another 3 now and third file should appear but still not first
-    REPEAT(3,q.push(0));
+    REPEAT(3,q.push("0"));
     q.syncronize();
     EXPECT_NOT_EXISTS("t_PersistentFilePagedQueue_04\\queue1.q");
     EXPECT_EXISTS("t_PersistentFilePagedQueue_04\\queue2.q");
     EXPECT_EXISTS("t_PersistentFilePagedQueue_04\\queue3.q");
   }
   {
-    Utils::PersistentFilePagedQueue<int> q(dir,"queue",3);
+    Utils::PersistentFilePagedQueue<std::string> q(dir,"queue",3);
     // Pop three and only third file should be left
     REPEAT(3,q.pop());
     q.syncronize();
@@ -179,7 +180,7 @@ TEST(PersistentFilePagedQueueTest,paging)
     EXPECT_EXISTS("t_PersistentFilePagedQueue_04\\queue3.q");
   }
   {
-    Utils::PersistentFilePagedQueue<int> q(dir,"queue",3);
+    Utils::PersistentFilePagedQueue<std::string> q(dir,"queue",3);
     // Pop another three and they should be all gone
     REPEAT(3,q.pop());
     q.syncronize();
@@ -188,9 +189,9 @@ TEST(PersistentFilePagedQueueTest,paging)
     EXPECT_NOT_EXISTS("t_PersistentFilePagedQueue_04\\queue3.q");
   }
   {
-    Utils::PersistentFilePagedQueue<int> q(dir,"queue",3);
+    Utils::PersistentFilePagedQueue<std::string> q(dir,"queue",3);
     // Push three now and counter should reset to one
-    REPEAT(3,q.push(0));
+    REPEAT(3,q.push("0"));
     q.syncronize();
     EXPECT_EXISTS("t_PersistentFilePagedQueue_04\\queue1.q");
   }
@@ -225,3 +226,32 @@ TEST(PersistentFilePagedQueueTest,randomExercise)
   }
   RMDIR(dir);
 }
+
+TEST(PersistentFilePagedQueueTest,readAhead)
+{
+  // Pages already read ahead are stored with the rest
+  std::string dir = "t_PersistentFilePagedQueue_06";
+  RMDIR(dir);
+  MKDIR(dir);
+  {
+    int next = 0;
+    for (int n=0;n<4;++n) {
+      Utils::PersistentFilePagedQueue<int> q(dir,"queue",2,3);
+      for (int i=0;i<13;++i) {
+        q.push(n * 13 + i);
+      }
+      for (int i=0;i<9;++i) {
+        ASSERT_EQ(q.front(), next++);
+        q.pop();
+      }
+    }
+    Utils::PersistentFilePagedQueue<int> q(dir,"queue",2,3);
+    EXPECT_EQ(q.size(), 16u);
+    while (!q.empty()) {
+      ASSERT_EQ(q.front(), next++);
+      q.pop();
+    }
+    EXPECT_EQ(next, 52);
+  }
+  RMDIR(dir);
+}
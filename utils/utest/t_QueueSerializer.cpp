@@ -0,0 +1,158 @@
+#include <gtest/gtest.h>
+#include "QueueSerializer.h"
+#include "FilePagedQueue.h"
+#include <string>
+#include <queue>
+#include <filesystem>
+namespace fs = std::experimental::filesystem;
+
+#define MKDIR(dirname) \
+  fs::create_directory(dirname)
+
+#define RMDIR(directory) \
+  fs::remove_all(directory)
+
+namespace {
+  struct Point {
+    int x;
+    int y;
+  };
+
+  // Written as text by default
+  struct Named {
+    std::string name;
+    int value;
+  };
+
+  std::ostream& operator<<(std::ostream& os, const Named& named)
+  {
+    return os << named.name << ' ' << named.value;
+  }
+
+  std::istream& operator>>(std::istream& is, Named& named)
+  {
+    return is >> named.name >> named.value;
+  }
+
+  // A compact record with its own encoding
+  struct Compact {
+    std::string label;
+    unsigned char moves[3];
+  };
+}
+
+namespace Utils {
+  template<>
+  struct QueueSerializer<Compact> : QueuePageSerializer<Compact, QueueSerializer<Compact>> {
+    enum : size_t { fixed_size = 4 };
+
+    static void encode(const Compact& item, std::string& out)
+    {
+      out += item.label.empty() ? ' ' : item.label[0];
+      out.append((const char*)item.moves, 3);
+    }
+
+    static const char* decode(const char* begin, const char* end, Compact& item)
+    {
+      if (end - begin < 4) {
+        return nullptr;
+      }
+      item.label = std::string(1, begin[0]);
+      memcpy(item.moves, begin + 1, 3);
+      return begin + 4;
+    }
+  };
+}
+
+TEST(QueueSerializerTest,defaults)
+{
+  EXPECT_EQ(Utils::QueueSerializer<Point>::fixed_size, sizeof(Point));
+  EXPECT_EQ(Utils::QueueSerializer<std::string>::fixed_size, 0u);
+  EXPECT_EQ(Utils::QueueSerializer<Named>::fixed_size, 0u);
+
+  std::string out;
+  Utils::QueueSerializer<Point>::encode({3, -4}, out);
+  Utils::QueueSerializer<std::string>::encode("text", out);
+  Utils::QueueSerializer<Named>::encode({"seven", 7}, out);
+  EXPECT_EQ(out.size(), sizeof(Point) + 4 + 4 + 4 + 7);
+
+  const char* pos = out.data();
+  const char* end = pos + out.size();
+  Point p;
+  std::string s;
+  Named n;
+  pos = Utils::QueueSerializer<Point>::decode(pos, end, p);
+  ASSERT_NE(pos, nullptr);
+  pos = Utils::QueueSerializer<std::string>::decode(pos, end, s);
+  ASSERT_NE(pos, nullptr);
+  pos = Utils::QueueSerializer<Named>::decode(pos, end, n);
+  ASSERT_EQ(pos, end);
+  EXPECT_EQ(p.x, 3);
+  EXPECT_EQ(p.y, -4);
+  EXPECT_EQ(s, "text");
+  EXPECT_EQ(n.name, "seven");
+  EXPECT_EQ(n.value, 7);
+
+  // Records that are cut short are not read
+  EXPECT_EQ(Utils::QueueSerializer<Point>::decode(out.data(), out.data() + 3, p), nullptr);
+  EXPECT_EQ(Utils::QueueSerializer<std::string>::decode(out.data() + sizeof(Point),
+    out.data() + sizeof(Point) + 6, s), nullptr);
+}
+
+TEST(QueueSerializerTest,pages)
+{
+  std::queue<Point> points;
+  for (int i=0;i<10;++i) {
+    points.push({i, i * i});
+  }
+  std::string page;
+  Utils::QueueSerializer<Point>::encode_page(points, page);
+  EXPECT_TRUE(points.empty());
+  EXPECT_EQ(page.size(), 10 * sizeof(Point));
+
+  std::queue<Point> decoded;
+  EXPECT_FALSE(Utils::QueueSerializer<Point>::decode_page(page.data(),
+    page.data() + page.size() - 1, 10, decoded));
+  decoded = std::queue<Point>();
+  ASSERT_TRUE(Utils::QueueSerializer<Point>::decode_page(page.data(),
+    page.data() + page.size(), 10, decoded));
+  for (int i=0;i<10;++i) {
+    EXPECT_EQ(decoded.front().y, i * i);
+    decoded.pop();
+  }
+}
+
+TEST(QueueSerializerTest,custom)
+{
+  // A queue of a type with its own serializer pages through it
+  std::string dir = "t_QueueSerializer_01";
+  RMDIR(dir);
+  MKDIR(dir);
+  {
+    Utils::FilePagedQueue<Compact> q(dir,"queue",3);
+    for (int i=0;i<20;++i) {
+      Compact c = {std::string(1, (char)('a' + i)), {(unsigned char)i, 1, 2}};
+      q.push(c);
+    }
+    for (int i=0;i<20;++i) {
+      ASSERT_EQ(q.front().label, std::string(1, (char)('a' + i)));
+      EXPECT_EQ(q.front().moves[0], i);
+      q.pop();
+    }
+    // Text by default
+    Utils::FilePagedQueue<Named> named(dir,"named",2);
+    for (int i=0;i<10;++i) {
+      named.push({"n" + std::to_string(i), i});
+    }
+    for (int i=0;i<10;++i) {
+      EXPECT_EQ(named.front().value, i);
+      named.pop();
+    }
+  }
+  RMDIR(dir);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest( &argc, argv );
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,51 @@
+#include <gtest/gtest.h>
+#include "ThreadPool.h"
+#include <atomic>
+#include <vector>
+#include <stdexcept>
+
+TEST(ThreadPoolTest,submit)
+{
+  Utils::ThreadPool pool(4);
+  EXPECT_EQ(pool.size(), 4u);
+  std::vector<std::future<int>> results;
+  for (int i=0;i<100;++i) {
+    results.push_back(pool.submit([i]() { return i * i; }));
+  }
+  for (int i=0;i<100;++i) {
+    EXPECT_EQ(results[i].get(), i * i);
+  }
+}
+
+TEST(ThreadPoolTest,exception)
+{
+  Utils::ThreadPool pool(2);
+  std::future<int> result = pool.submit([]() -> int { throw std::runtime_error("failed"); });
+  EXPECT_THROW(result.get(), std::runtime_error);
+  // The pool carries on after a task throws
+  EXPECT_EQ(pool.submit([]() { return 1; }).get(), 1);
+}
+
+TEST(ThreadPoolTest,finishes_queued)
+{
+  std::atomic<int> count(0);
+  {
+    Utils::ThreadPool pool(3);
+    for (int i=0;i<1000;++i) {
+      pool.submit([&count]() { ++count; });
+    }
+  }
+  EXPECT_EQ(count, 1000);
+}
+
+TEST(ThreadPoolTest,default_size)
+{
+  Utils::ThreadPool pool;
+  EXPECT_GE(pool.size(), 1u);
+  EXPECT_EQ(pool.queued(), 0u);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest( &argc, argv );
+  return RUN_ALL_TESTS();
+}